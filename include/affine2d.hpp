@@ -0,0 +1,228 @@
+#pragma once
+
+#include "matrix.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+
+namespace love
+{
+    /*
+    ** 2D affine transform, the upper 2x3 of a Matrix4:
+    ** x' = a * x + c * y + tx, y' = b * x + d * y + ty.
+    ** Everything Graphics draws is placed by one of these, so every operation
+    ** touches six floats instead of going through citro3d's 4x4 routines.
+    */
+    class Affine2D
+    {
+      public:
+        /*
+        ** What a transform can do, kept up to date by every operation so that
+        ** a draw picks its kernel without inspecting the elements. Each one
+        ** contains the ones before it, except that scale and rigid only meet
+        ** in affine; see Combine.
+        */
+        enum Classification
+        {
+            TRANSFORM_IDENTITY,
+            TRANSFORM_TRANSLATION,
+            TRANSFORM_SCALE, //< axis-aligned scale and translation
+            TRANSFORM_RIGID, //< rotation and translation, lengths are kept
+            TRANSFORM_AFFINE
+        };
+
+        /* the classification of a transform made of one of each */
+        static Classification Combine(Classification first, Classification second)
+        {
+            if (first == second || std::min(first, second) <= TRANSFORM_TRANSLATION)
+                return std::max(first, second);
+
+            return TRANSFORM_AFFINE;
+        }
+
+        Affine2D() :
+            a(1.0f),
+            b(0.0f),
+            c(0.0f),
+            d(1.0f),
+            tx(0.0f),
+            ty(0.0f),
+            classification(TRANSFORM_IDENTITY)
+        {}
+
+        Affine2D(float a, float b, float c, float d, float tx, float ty,
+                 Classification classification = TRANSFORM_AFFINE) :
+            a(a),
+            b(b),
+            c(c),
+            d(d),
+            tx(tx),
+            ty(ty),
+            classification(classification)
+        {}
+
+        /* the 2D part of @matrix; its z row and column are dropped */
+        explicit Affine2D(const Matrix4& matrix);
+
+        Classification GetClassification() const
+        {
+            return this->classification;
+        }
+
+        void SetIdentity()
+        {
+            *this = Affine2D();
+        }
+
+        /* these apply before the current transform, like Matrix4's */
+
+        void Translate(float x, float y)
+        {
+            if (x == 0.0f && y == 0.0f)
+                return;
+
+            this->tx += this->a * x + this->c * y;
+            this->ty += this->b * x + this->d * y;
+
+            this->classification = std::max(this->classification, TRANSFORM_TRANSLATION);
+        }
+
+        void Rotate(float r);
+
+        void Scale(float sx, float sy)
+        {
+            if (sx == 1.0f && sy == 1.0f)
+                return;
+
+            this->a *= sx;
+            this->b *= sx;
+            this->c *= sy;
+            this->d *= sy;
+
+            this->classification = Combine(this->classification, TRANSFORM_SCALE);
+        }
+
+        void Shear(float kx, float ky);
+
+        /* @other applies first */
+        Affine2D operator*(const Affine2D& other) const;
+
+        void operator*=(const Affine2D& other)
+        {
+            *this = *this * other;
+        }
+
+        /* the identity if this transform is not invertible */
+        Affine2D Inverse() const;
+
+        Vector2 Transform(float x, float y) const
+        {
+            return Vector2(this->a * x + this->c * y + this->tx,
+                           this->b * x + this->d * y + this->ty);
+        }
+
+        Vector2 Transform(const Vector2& point) const
+        {
+            return this->Transform(point.x, point.y);
+        }
+
+        /*
+        ** Batch transforms, which pick a copy, offset, scale or full affine
+        ** kernel once for all @size points. @dst and @src may be the same.
+        */
+        template<typename Vdst, typename Vsrc>
+        void TransformXY(Vdst* dst, const Vsrc* src, int size) const
+        {
+            this->Apply(src, size, [dst](int i, float x, float y) {
+                dst[i].x = x;
+                dst[i].y = y;
+            });
+        }
+
+        /* same, into the position of each vertex of @dst, with z = 0 */
+        template<typename V>
+        void TransformPositions(V* dst, const Vector2* src, int size) const
+        {
+            this->Apply(src, size, [dst](int i, float x, float y) {
+                dst[i].position = { x, y, 0.0f };
+            });
+        }
+
+      private:
+        template<typename Vsrc, typename Store>
+        void Apply(const Vsrc* src, int size, Store&& store) const;
+
+        float a;
+        float b;
+        float c;
+        float d;
+        float tx;
+        float ty;
+
+        Classification classification;
+    };
+
+    template<typename Vsrc, typename Store>
+    void Affine2D::Apply(const Vsrc* src, int size, Store&& store) const
+    {
+        /* copies, so that stores through @store cannot force reloads */
+        const float a = this->a, b = this->b, c = this->c, d = this->d;
+        const float tx = this->tx, ty = this->ty;
+
+        switch (this->classification)
+        {
+            case TRANSFORM_IDENTITY:
+            {
+                for (int i = 0; i < size; i++)
+                    store(i, src[i].x, src[i].y);
+
+                break;
+            }
+            case TRANSFORM_TRANSLATION:
+            {
+                for (int i = 0; i < size; i++)
+                    store(i, src[i].x + tx, src[i].y + ty);
+
+                break;
+            }
+            case TRANSFORM_SCALE:
+            {
+                for (int i = 0; i < size; i++)
+                    store(i, a * src[i].x + tx, d * src[i].y + ty);
+
+                break;
+            }
+            default:
+            {
+                int i = 0;
+
+                /*
+                ** Four points at a time: the VFP11 pipelines its multiplies,
+                ** and independent points keep it busy while each result waits.
+                */
+                for (; i + 4 <= size; i += 4)
+                {
+                    const float x0 = src[i + 0].x, y0 = src[i + 0].y;
+                    const float x1 = src[i + 1].x, y1 = src[i + 1].y;
+                    const float x2 = src[i + 2].x, y2 = src[i + 2].y;
+                    const float x3 = src[i + 3].x, y3 = src[i + 3].y;
+
+                    store(i + 0, a * x0 + c * y0 + tx, b * x0 + d * y0 + ty);
+                    store(i + 1, a * x1 + c * y1 + tx, b * x1 + d * y1 + ty);
+                    store(i + 2, a * x2 + c * y2 + tx, b * x2 + d * y2 + ty);
+                    store(i + 3, a * x3 + c * y3 + tx, b * x3 + d * y3 + ty);
+                }
+
+                for (; i < size; i++)
+                {
+                    const float x = src[i].x;
+                    const float y = src[i].y;
+
+                    store(i, a * x + c * y + tx, b * x + d * y + ty);
+                }
+
+                break;
+            }
+        }
+    }
+} // namespace love
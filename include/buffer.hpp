@@ -12,11 +12,21 @@ namespace love
     struct DrawBuffer
     {
       public:
-        DrawBuffer(size_t size) : info {}, data((Vertex*)linearAlloc(size)), size(size), valid(true)
+        /*
+        ** @size bytes of vertices @stride bytes apart, made of @attributes loaders
+        ** in @permutation order. The defaults describe a Vertex.
+        */
+        DrawBuffer(size_t size, size_t stride = VERTEX_SIZE, int attributes = 3,
+                   uint64_t permutation = 0x210) :
+            info {},
+            data(linearAlloc(size)),
+            size(size),
+            stride(stride),
+            valid(true)
         {
             BufInfo_Init(&this->info);
 
-            int result = BufInfo_Add(&this->info, (void*)this->data, VERTEX_SIZE, 3, 0x210);
+            int result = BufInfo_Add(&this->info, this->data, stride, attributes, permutation);
 
             if (result < 0)
                 this->valid = false;
@@ -34,9 +44,10 @@ namespace love
 
         DrawBuffer& operator=(const DrawBuffer&) = delete;
 
-        Vertex* GetData()
+        template<typename T = Vertex>
+        T* GetData()
         {
-            return this->data;
+            return (T*)this->data;
         }
 
         C3D_BufInfo* GetBuffer()
@@ -51,17 +62,29 @@ namespace love
 
         void FlushDataCache()
         {
-            Result result = GSPGPU_FlushDataCache((void*)this->data, this->size);
+            this->FlushDataCache(this->size / this->stride);
+        }
+
+        /* flushes only the first @count vertices */
+        void FlushDataCache(size_t count)
+        {
+            Result result = GSPGPU_FlushDataCache(this->data, count * this->stride);
 
             if (R_FAILED(result))
                 this->valid = false;
         }
 
+        size_t GetCapacity() const
+        {
+            return this->size / this->stride;
+        }
+
       private:
         C3D_BufInfo info;
 
-        vertex::Vertex* data;
+        void* data;
         uint32_t size;
+        uint32_t stride;
 
         bool valid;
     };
@@ -130,6 +130,17 @@ struct Color
         return Color::FromTile<V>(texture->data, texture->width, position);
     }
 
+    /*
+    ** Index of the pixel at @position inside tiled image data, for formats
+    ** that are not a whole number of bytes per pixel
+    ** @param width: width of the image
+    ** @param position: Vector2 coordinate inside the image ([0-width-1], [0-height-1])
+    */
+    static unsigned TileIndex(const unsigned width, love::Vector2 position)
+    {
+        return indexOfTile(width, position.x, position.y);
+    }
+
     float r;
     float g;
     float b;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
 #include "buffer.hpp"
 #include "color.hpp"
@@ -22,134 +23,42 @@ namespace love
             TEXENV_MODE_PRIMITIVE,
             TEXENV_MODE_TEXTURE,
             TEXENV_MODE_TEXT,
+            TEXENV_MODE_DISTANCE_FIELD,
             TEXENV_MODE_MAX_ENUM
         };
 
-        DrawCommand(int vertexCount, vertex::PrimitiveType mode = vertex::PRIMITIVE_TRIANGLE_FAN) :
+        /*
+        ** Draws @vertexCount vertices that were already written to the
+        ** Renderer's frame vertex buffer, starting at vertex @first.
+        */
+        DrawCommand(int vertexCount, int first, TEXENV_MODE texEnv,
+                    vertex::PrimitiveType mode = vertex::PRIMITIVE_TRIANGLES) :
             mode(mode),
-            positions {},
             count(vertexCount),
-            size(vertexCount * vertex::VERTEX_SIZE),
+            first(first),
             handles { nullptr }
         {
             if (vertexCount == 0)
                 throw love::Exception("Invalid vertex count.");
 
-            try
-            {
-                this->positions = std::make_unique<Vector2[]>(vertexCount);
-            }
-            catch (std::bad_alloc&)
-            {
-                throw love::Exception("Out of memory.");
-            }
-        }
-
-        ~DrawCommand()
-        {}
-
-        const std::unique_ptr<Vector2[]>& Positions() const
-        {
-            return this->positions;
-        }
-
-        void FillVertices(const Color& color)
-        {
-            this->SetTexEnv(TEXENV_MODE_PRIMITIVE);
-
-            this->buffer  = std::make_shared<DrawBuffer>(this->size);
-            auto vertices = this->buffer->GetData();
-
-            for (size_t index = 0; index < this->count; index++)
-            {
-                // clang-format off
-                vertices[index] =
-                {
-                    .position = { this->positions[index].x, this->positions[index].y, 0 },
-                    .color    = color.array(),
-                    .texcoord = { 0, 0 }
-                };
-                // clang-format on
-            }
-
-            this->buffer->FlushDataCache();
-        }
-
-        void FillVertices(Color* colors)
-        {
-            this->SetTexEnv(TEXENV_MODE_PRIMITIVE);
-
-            this->buffer  = std::make_shared<DrawBuffer>(this->size);
-            auto vertices = this->buffer->GetData();
-
-            for (size_t index = 0; index < this->count; index++)
-            {
-                // clang-format off
-                vertices[index] =
-                {
-                    .position = { this->positions[index].x, this->positions[index].y, 0 },
-                    .color    = colors[index].array(),
-                    .texcoord = { 0, 0 }
-                };
-                // clang-format on
-            }
-
-            this->buffer->FlushDataCache();
-        }
-
-        void FillVertices(const vertex::Vertex* data)
-        {
-            this->SetTexEnv(TEXENV_MODE_TEXT);
-
-            this->buffer  = std::make_shared<DrawBuffer>(this->size);
-            auto vertices = this->buffer->GetData();
-
-            for (size_t index = 0; index < this->count; index++)
-            {
-                // clang-format off
-                vertices[index] =
-                {
-                    .position = { this->positions[index].x, this->positions[index].y, 0 },
-                    .color    = data[index].color,
-                    .texcoord = data[index].texcoord
-                };
-                // clang-format on
-            }
-
-            this->buffer->FlushDataCache();
-        }
-
-        void FillVertices(const Color& color, const Vector2* textureCoords)
-        {
-            this->SetTexEnv(TEXENV_MODE_TEXTURE);
-
-            this->buffer  = std::make_shared<DrawBuffer>(this->size);
-            auto vertices = this->buffer->GetData();
-
-            for (size_t index = 0; index < this->count; index++)
-            {
-                // clang-format off
-                vertices[index] =
-                {
-                    .position = { this->positions[index].x, this->positions[index].y, 0 },
-                    .color    = color.array(),
-                    .texcoord = { textureCoords[index].x, textureCoords[index].y }
-                };
-                // clang-format on
-            }
-
-            this->buffer->FlushDataCache();
+            this->SetTexEnv(texEnv);
         }
 
         vertex::PrimitiveType mode;
-        std::unique_ptr<Vector2[]> positions;
 
-        size_t count;
-        size_t size;
+        size_t count; //< of indices instead, when there are indices
+        int first = 0;
+
+        /* from Renderer::GetIndices, to draw the frame vertex buffer indexed */
+        const uint16_t* indices = nullptr;
 
         std::vector<C3D_Tex*> handles;
 
-        std::shared_ptr<DrawBuffer> buffer;
+        /*
+        ** Set when the vertices came from Renderer::GetFixedColorVertices,
+        ** to give every one of them this color.
+        */
+        std::optional<Color> fixedColor;
 
       private:
         static inline TEXENV_MODE m_texEnvMode = TEXENV_MODE_MAX_ENUM;
@@ -159,6 +68,13 @@ namespace love
             if (m_texEnvMode == mode)
                 return;
 
+            /* only distance fields use the second stage and the alpha test */
+            if (m_texEnvMode == TEXENV_MODE_DISTANCE_FIELD)
+            {
+                C3D_TexEnvInit(C3D_GetTexEnv(1));
+                C3D_AlphaTest(false, GPU_ALWAYS, 0);
+            }
+
             C3D_TexEnv* env = C3D_GetTexEnv(0);
             C3D_TexEnvInit(env);
 
@@ -190,6 +106,36 @@ namespace love
 
                     break;
                 }
+                case TEXENV_MODE_DISTANCE_FIELD:
+                {
+                    /*
+                    ** The texture alpha is a distance with the glyph edge at 0.5.
+                    ** (distance - 0.375) * 4 turns it into coverage that is 0.5 on
+                    ** the edge and ramps over a texel to either side at the default
+                    ** bcfnt2sdf spread, then the second stage applies the vertex alpha.
+                    */
+                    C3D_TexEnvSrc(env, C3D_RGB, GPU_PRIMARY_COLOR, GPU_PRIMARY_COLOR,
+                                  GPU_PRIMARY_COLOR);
+                    C3D_TexEnvFunc(env, C3D_RGB, GPU_REPLACE);
+
+                    C3D_TexEnvSrc(env, C3D_Alpha, GPU_TEXTURE0, GPU_CONSTANT, GPU_PRIMARY_COLOR);
+                    C3D_TexEnvFunc(env, C3D_Alpha, GPU_SUBTRACT);
+                    C3D_TexEnvScale(env, C3D_Alpha, GPU_TEVSCALE_4);
+                    C3D_TexEnvColor(env, 0x60000000);
+
+                    C3D_TexEnv* edge = C3D_GetTexEnv(1);
+                    C3D_TexEnvInit(edge);
+
+                    C3D_TexEnvSrc(edge, C3D_Both, GPU_PREVIOUS, GPU_PRIMARY_COLOR,
+                                  GPU_PRIMARY_COLOR);
+                    C3D_TexEnvFunc(edge, C3D_RGB, GPU_REPLACE);
+                    C3D_TexEnvFunc(edge, C3D_Alpha, GPU_MODULATE);
+
+                    /* drop fragments outside the glyph so they leave depth alone */
+                    C3D_AlphaTest(true, GPU_GREATER, 0);
+
+                    break;
+                }
                 default:
                     throw love::Exception("Not allowed.");
             }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "affine2d.hpp"
 #include "color.hpp"
+#include "glyphtable.hpp"
 #include "matrix.hpp"
 #include "object.hpp"
 #include "rasterizer.hpp"
@@ -9,6 +11,7 @@
 
 #include <array>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -56,12 +59,15 @@ namespace love
             std::vector<IndexedColor> colors;
         };
 
-        struct Glyph
+        using Glyph = GlyphTable::Glyph;
+
+        /* a wrapped line as a span of the source codepoints */
+        struct WrapLine
         {
-            C3D_Tex* texture;
-            int spacing;
-            std::array<vertex::Vertex, 0x06> vertices;
-            int sheet;
+            int start;
+            int count;
+            int width;
+            int last; //< last codepoint read to place the break, may lie past the span
         };
 
         struct DrawCommand
@@ -77,10 +83,7 @@ namespace love
         Font(Rasterizer* rasterizer);
 
         virtual ~Font()
-        {
-            this->glyphs.clear();
-            this->textures.clear();
-        }
+        {}
 
         void Print(Graphics& graphics, const ColoredStrings& text, const Matrix4& transform,
                    const Color& color);
@@ -88,6 +91,29 @@ namespace love
         void Printf(Graphics& graphics, const ColoredStrings& text, float wrap, AlignMode alignment,
                     const Matrix4& matrix, const Color& color);
 
+        /* adds every glyph of @charset to the glyph table in one batch */
+        void Prewarm(std::string_view charset);
+
+        void Prewarm(const std::vector<std::string>& strings);
+
+        /*
+        ** Writes the glyph table to @path, so that a later launch can load
+        ** it with LoadGlyphCache instead of recomputing every glyph. The table
+        ** is in unscaled font units, so one file serves the face at any size.
+        ** LoadGlyphCache returns false, leaving the table as is, when the
+        ** file is missing, truncated, from another cache version, or its
+        ** face size or layout hash does not match this face.
+        */
+        bool SaveGlyphCache(const char* path) const;
+
+        bool LoadGlyphCache(const char* path);
+
+        /* see GlyphTable::SetRepacking, applies to every Font on this face */
+        bool SetRepacking(bool enable, int atlasCount = 1)
+        {
+            return this->table->SetRepacking(enable, atlasCount);
+        }
+
         int GetWidth(std::string_view text);
 
         int GetWidth(uint32_t glyph);
@@ -98,6 +124,15 @@ namespace love
         void GetWrap(const ColoredCodepoints& codepoints, float wraplimit,
                      std::vector<ColoredCodepoints>& lines, std::vector<int>* linewidths = nullptr);
 
+        void GetWrap(const Codepoints& codepoints, float wraplimit, std::vector<WrapLine>& lines);
+
+        /*
+        ** Wraps a single line starting at @start. Line breaks only depend on the
+        ** codepoints from @start onward, so wrapping can resume at any line start.
+        ** Returns the start of the next line, or -1 at the end of the text.
+        */
+        int GetWrapLine(const Codepoints& codepoints, int start, float wraplimit, WrapLine& line);
+
         const float GetHeight() const
         {
             return this->height;
@@ -128,53 +163,71 @@ namespace love
             return 0.0f;
         }
 
+        /* sheet changes in glyph order for the last printed string, before bucketing */
+        int GetSheetSwitches() const
+        {
+            return this->sheetSwitches;
+        }
+
       private:
-        static constexpr uint32_t TAB_GLYPH      = 9;
         static constexpr uint32_t SPACE_GLYPH    = 32;
         static constexpr uint32_t NEWLINE_GLYPH  = 10;
         static constexpr uint32_t CARRIAGE_GLYPH = 13;
 
-        static constexpr int SPACES_PER_TAB = 4;
-
         static void GetCodepointsFromString(const ColoredStrings& strings, ColoredCodepoints& out);
 
         static void GetCodepointsFromString(std::string_view text, Codepoints& out);
 
-        GlyphData* GetRasterizerGlyphData(uint32_t glyph);
+        void Prewarm(Codepoints& codepoints);
 
-        const Glyph& AddGlyph(uint32_t glyph);
+        std::vector<DrawCommand> ReserveSheets(const Codepoints& codepoints, size_t& total);
 
-        std::vector<DrawCommand> GenerateVertices(const ColoredCodepoints& codepoints,
-                                                  const Color& color,
-                                                  std::vector<vertex::Vertex>& vertices,
-                                                  float extraSpacing = 0.0f, Vector2 offset = {},
-                                                  TextInfo* info = nullptr);
+        /* @vertices is a Vertex or, when every glyph has the same color, a FixedColorVertex */
+        template<typename V>
+        void GenerateVertices(const ColoredCodepoints& codepoints, int start, int end,
+                              const Color& color, const Affine2D& transform, V* vertices,
+                              std::vector<DrawCommand>& commands, float extraSpacing = 0.0f,
+                              Vector2 offset = {}, TextInfo* info = nullptr);
 
-        std::vector<DrawCommand> GenerateVerticesFormatted(const ColoredCodepoints& codepoints,
-                                                           const Color& color, float wrap,
-                                                           AlignMode align,
-                                                           std::vector<vertex::Vertex>& vertices,
-                                                           TextInfo* info = nullptr);
+        template<typename V>
+        void GenerateVerticesFormatted(const ColoredCodepoints& codepoints, const Color& color,
+                                       float wrap, AlignMode align, const Affine2D& transform,
+                                       V* vertices, std::vector<DrawCommand>& commands,
+                                       TextInfo* info = nullptr);
 
-        const Glyph& FindGlyph(uint32_t glyph);
+        /* the color of every glyph of @codepoints drawn in @color, if they all share one */
+        static std::optional<Color> GetFixedColor(const ColoredCodepoints& codepoints,
+                                                  const Color& color);
 
-        void Render(Graphics& graphics, const Matrix4& transform,
-                    const std::vector<DrawCommand>& commands,
-                    const std::vector<vertex::Vertex>& vertices);
+        /*
+        ** Reserves @count vertices of the format @fixedColor calls for and passes
+        ** them to @generate. Returns false when the frame vertex buffer is full.
+        */
+        template<typename Generator>
+        bool GenerateInto(size_t count, bool fixedColor, int& first, Generator&& generate);
+
+        /* see GlyphTable::Find for @draw */
+        const Glyph& FindGlyph(uint32_t glyph, bool draw = false);
+
+        void Render(const std::vector<DrawCommand>& commands, int first,
+                    const std::optional<Color>& fixedColor);
+
+        int GetSpacing(const Glyph& glyph) const
+        {
+            return (int)(glyph.advance * this->scale);
+        }
 
         std::vector<StrongReference<Rasterizer>> rasterizers;
-        std::vector<C3D_Tex> textures;
+        StrongReference<GlyphTable> table;
 
         bool LoadVolatile();
 
-        void CreateTexture();
-
         float height;
-        bool useSpacesAsTab;
         float scale;
-        std::unordered_map<uint32_t, Glyph> glyphs;
-        bool inited;
 
-        std::unordered_map<uint32_t, float> glyphWidths;
+        int sheetSwitches;
+
+        /* per-sheet vertex counts, then the command index of each sheet */
+        std::vector<int> sheetCounts;
     };
 } // namespace love
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <3ds.h>
+
+#include <array>
+#include <vector>
+
+namespace love
+{
+    /*
+    ** Flattened CMAP/CWDH lookup for a BCFNT face.
+    ** libctru walks the CMAP chain (including scan sections) and the CWDH chain
+    ** for every lookup; this resolves both once at load time so that a codepoint
+    ** maps to its glyph index and widths with two array reads.
+    */
+    class FontIndex
+    {
+      public:
+        FontIndex();
+
+        void Build(CFNT_s* font);
+
+        void Clear();
+
+        bool IsBuilt() const
+        {
+            return this->font != nullptr;
+        }
+
+        int GetGlyphIndex(uint32_t codepoint) const
+        {
+            if (codepoint > MAX_CODEPOINT)
+                return this->alterCharIndex;
+
+            const auto page = this->pages[codepoint >> PAGE_SHIFT];
+            return this->entries[page + (codepoint & PAGE_MASK)];
+        }
+
+        const charWidthInfo_s& GetWidthInfo(int glyphIndex) const;
+
+        /* mirrors fontCalcGlyphPos, but reads widths from the flattened CWDH */
+        void CalcGlyphPos(fontGlyphPos_s* out, int glyphIndex, float scaleX, float scaleY) const;
+
+        size_t GetMemoryUsage() const;
+
+      private:
+        static constexpr uint32_t MAX_CODEPOINT = 0xFFFF;
+
+        static constexpr uint32_t PAGE_SHIFT = 0x08;
+        static constexpr uint32_t PAGE_SIZE  = (1 << PAGE_SHIFT);
+        static constexpr uint32_t PAGE_MASK  = PAGE_SIZE - 1;
+        static constexpr uint32_t PAGE_COUNT = (MAX_CODEPOINT + 1) >> PAGE_SHIFT;
+
+        static constexpr uint16_t UNMAPPED = 0xFFFF;
+
+        void SetGlyphIndex(uint32_t codepoint, uint16_t glyphIndex);
+
+        CFNT_s* font;
+        uint16_t alterCharIndex;
+
+        /* page 0 of entries is shared by every page without a mapping */
+        std::array<uint32_t, PAGE_COUNT> pages;
+        std::vector<uint16_t> entries;
+
+        std::vector<charWidthInfo_s> widths;
+    };
+} // namespace love
@@ -3,8 +3,11 @@
 #include <3ds.h>
 
 #include "data.hpp"
+#include "fontindex.hpp"
 #include "rasterizer.hpp"
 
+#include <string>
+
 namespace love
 {
     class FontModule
@@ -18,12 +21,35 @@ namespace love
 
         static constexpr auto FONT_ARCHIVE = 0x0004009B00014002ULL;
 
-        static CFNT_s* LoadSystemFont(CFG_Region region);
+        /*
+        ** When set, system fonts from other regions are decompressed once and
+        ** kept here; later loads read the cached BCFNT instead. Empty disables it.
+        */
+        static inline std::string cacheDirectory {};
+
+        /*
+        ** Passing an @index builds the flattened codepoint/width lookup
+        ** for the loaded face, see FontIndex.
+        */
+        static CFNT_s* LoadSystemFont(CFG_Region region, FontIndex* index = nullptr);
+
+        static CFNT_s* LoadFromFile(const void* data, size_t size, FontIndex* index = nullptr);
 
-        static CFNT_s* LoadFromFile(const void* data, size_t size);
+        /*
+        ** Reads the font at @path straight into linear memory, without an
+        ** intermediate copy. Free with FreeFont.
+        */
+        static CFNT_s* LoadFromPath(const char* path, FontIndex* index = nullptr);
+
+        static void FreeFont(CFNT_s* font);
 
         Rasterizer* NewRasterizer(const void* data, size_t dataSize, float size = 16.0f);
 
+        Rasterizer* NewRasterizer(const char* path, float size = 16.0f);
+
+        /* shares @base's face, so Fonts of both sizes also share one GlyphTable */
+        Rasterizer* NewRasterizer(Rasterizer* base, float size);
+
         Rasterizer* NewRasterizer(float size, CFG_Region region = CFG_REGION_USA);
 
       private:
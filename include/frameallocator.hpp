@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace love
+{
+    /*
+    ** Bump allocator for temporaries that live until the frame is presented,
+    ** such as the points of a shape, instead of variable-length arrays on the
+    ** small thread stacks or one heap allocation per draw. Renderer::Present
+    ** resets it. Once the arena is used up, further allocations that frame get
+    ** heap blocks of their own, freed at the same reset.
+    */
+    class FrameAllocator
+    {
+      public:
+        static constexpr size_t CAPACITY = 0x40000;
+
+        static FrameAllocator& Instance()
+        {
+            static FrameAllocator allocator;
+            return allocator;
+        }
+
+        /* @count default-constructed Ts, never nullptr */
+        template<typename T>
+        T* Allocate(size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "Reset does not run destructors.");
+
+            auto* memory = (T*)this->AllocateBytes(count * sizeof(T), alignof(T));
+            std::uninitialized_value_construct_n(memory, count);
+
+            return memory;
+        }
+
+        void Reset();
+
+        /* bytes handed out this frame, including heap blocks */
+        size_t GetUsed() const
+        {
+            return this->used + this->overflowSize;
+        }
+
+        /* most bytes any frame so far has needed; above CAPACITY means it overflowed */
+        size_t GetHighWater() const
+        {
+            return this->highWater;
+        }
+
+      private:
+        FrameAllocator();
+
+        void* AllocateBytes(size_t size, size_t alignment);
+
+        std::unique_ptr<uint8_t[]> arena;
+        size_t used;
+
+        std::vector<std::unique_ptr<uint8_t[]>> overflow;
+        size_t overflowSize;
+
+        size_t highWater;
+    };
+} // namespace love
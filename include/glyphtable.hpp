@@ -0,0 +1,166 @@
+#pragma once
+
+#include <citro3d.h>
+
+#include "object.hpp"
+#include "rasterizer.hpp"
+#include "strongreference.hpp"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+namespace love
+{
+    /*
+    ** Glyph quads and sheet textures for one BCFNT face, in unscaled font units.
+    ** Sheet texcoords do not depend on the size a face is drawn at, so every Font
+    ** built on the same face shares one table and only applies its own scale.
+    */
+    class GlyphTable : public Object
+    {
+      public:
+        static inline Type type = Type("GlyphTable", &Object::type);
+
+        struct Glyph
+        {
+            C3D_Tex* texture; //< nullptr when the glyph has nothing to draw
+            int sheet;
+            int bearingX;
+            int width;
+            int advance;
+            std::array<float, 0x04> texcoords; //< left, top, right, bottom
+            int slot = -1;                     //< atlas slot, -1 when drawn from its sheet
+        };
+
+        /* returns the table for @rasterizer's face, creating it if needed */
+        static StrongReference<GlyphTable> Get(Rasterizer* rasterizer);
+
+        virtual ~GlyphTable();
+
+        /*
+        ** Pass @draw only when the glyph is about to be drawn: when repacking,
+        ** that copies it into an atlas slot and keeps the slot for this frame.
+        ** Measuring text must not, or it would evict glyphs that are drawn.
+        */
+        const Glyph& Find(uint32_t codepoint, bool draw = false)
+        {
+            const auto iterator = this->glyphs.find(codepoint);
+
+            if (iterator == this->glyphs.end())
+                return this->Add(codepoint, draw);
+
+            if (draw && this->repacking)
+                this->Touch(iterator->first, iterator->second);
+
+            return iterator->second;
+        }
+
+        bool Contains(uint32_t codepoint) const
+        {
+            return this->glyphs.find(codepoint) != this->glyphs.end();
+        }
+
+        void Reserve(size_t count)
+        {
+            this->glyphs.reserve(this->glyphs.size() + count);
+        }
+
+        size_t GetGlyphCount() const
+        {
+            return this->glyphs.size();
+        }
+
+        /* atlas textures are numbered after the face's own sheets */
+        size_t GetSheetCount() const
+        {
+            return this->textures.size() + this->atlases.size();
+        }
+
+        C3D_Tex* GetTexture(int sheet)
+        {
+            if (sheet < (int)this->textures.size())
+                return &this->textures[sheet];
+
+            return &this->atlases[sheet - this->textures.size()];
+        }
+
+        /*
+        ** Repacking copies every glyph that gets drawn from the face's sheets
+        ** into up to @atlasCount atlas textures of their own, so that text mixing
+        ** many sheets binds one texture. When the atlases are full, the glyph
+        ** least recently drawn before this frame is evicted back to its sheet.
+        ** Returns false if the sheet format cannot be repacked (ETC1).
+        ** Only toggle it between frames.
+        */
+        bool SetRepacking(bool enable, int atlasCount = 1);
+
+        bool IsRepacking() const
+        {
+            return this->repacking;
+        }
+
+        /* flushes atlas pixels written since the last call, before drawing */
+        void Flush();
+
+        /* one distance field face draws crisp at every size */
+        bool IsDistanceField() const
+        {
+            return this->distanceField;
+        }
+
+        bool Save(const char* path) const;
+
+        bool Load(const char* path);
+
+      private:
+        static constexpr uint32_t TAB_GLYPH   = 9;
+        static constexpr uint32_t SPACE_GLYPH = 32;
+
+        static constexpr int SPACES_PER_TAB = 4;
+
+        GlyphTable(Rasterizer* rasterizer);
+
+        static constexpr int ATLAS_SIZE = 512;
+
+        struct AtlasSlot
+        {
+            uint32_t codepoint;
+            Glyph original; //< the glyph as drawn from its sheet
+            uint32_t frame; //< last frame the glyph was drawn in
+            bool used;
+        };
+
+        const Glyph& Add(uint32_t codepoint, bool draw);
+
+        void Touch(uint32_t codepoint, Glyph& glyph);
+
+        int FindSlot() const;
+
+        void CopyToSlot(const Glyph& glyph, int slot, Glyph& out);
+
+        void ClearAtlases();
+
+        StrongReference<Rasterizer> rasterizer;
+        CFNT_s* face;
+
+        std::vector<C3D_Tex> textures;
+        std::unordered_map<uint32_t, Glyph> glyphs;
+
+        bool useSpacesAsTab;
+        bool distanceField;
+
+        bool repacking;
+        bool dirty;
+
+        std::vector<C3D_Tex> atlases;
+        std::vector<AtlasSlot> slots;
+
+        int slotWidth;
+        int slotHeight;
+        int slotColumns;
+        int slotsPerAtlas;
+
+        static inline std::unordered_map<const CFNT_s*, GlyphTable*> tables {};
+    };
+} // namespace love
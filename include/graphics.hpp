@@ -1,9 +1,12 @@
 #pragma once
 
+#include "affine2d.hpp"
 #include "color.hpp"
 #include "exception.hpp"
 #include "font.hpp"
 #include "matrix.hpp"
+#include "polyline/polyline.hpp"
+#include "triangulator.hpp"
 #include "vector.hpp"
 
 #include <span>
@@ -37,7 +40,8 @@ namespace love
         enum LineStyle
         {
             LINE_SMOOTH,
-            LINE_ROUGH
+            LINE_ROUGH,
+            LINE_SMOOTH_RAMP //< smooth, faded by a ramp texture instead of extra geometry
         };
 
         enum StackType
@@ -48,6 +52,21 @@ namespace love
 
         static constexpr auto MAX_USER_STACK_DEPTH = 0x80;
 
+        /* furthest an ellipse's edge may stray from its chords, in pixels */
+        static constexpr float ELLIPSE_PIXEL_ERROR = 0.25f;
+
+        static constexpr int MIN_ELLIPSE_POINTS = 8;
+        static constexpr int MAX_ELLIPSE_POINTS = 1024;
+
+        /* one line of a Lines batch */
+        struct Line
+        {
+            std::span<Vector2> points;
+            Color color { 1, 1, 1, 1 };
+            float width   = 1.0f;
+            LineJoin join = LINE_JOIN_MITER;
+        };
+
         struct DisplayState
         {
             Color foreground { 1, 1, 1, 1 };
@@ -62,14 +81,30 @@ namespace love
 
         Graphics();
 
+        ~Graphics();
+
         static Graphics& Instance()
         {
             static Graphics graphics;
             return graphics;
         }
 
+        /*
+        ** Long lines are drawn in several triangle strips of under 65k vertices.
+        ** A line is cut short where the frame vertex buffer runs out.
+        */
         void Polyline(const std::span<Vector2> points);
 
+        /*
+        ** Tessellates every line into one triangle strip in the frame's vertex
+        ** buffer, joined by degenerate triangles, and draws them in one call.
+        ** The line style and transform apply to the whole set.
+        */
+        void Lines(std::span<const Line> lines);
+
+        /* draws @lines with the current color, line width and line join */
+        void Lines(std::span<const std::span<Vector2>> lines);
+
         void Polyfill(DrawMode mode, std::span<love::Vector2> points, const Color& color,
                       bool skipLastVertex = true);
 
@@ -79,6 +114,9 @@ namespace love
         void Rectangle(DrawMode mode, float x, float y, float width, float height, float rx,
                        float ry, int points, const Color& color);
 
+        void Rectangle(DrawMode mode, float x, float y, float width, float height, float rx,
+                       float ry, const Color& color);
+
         void Ellipse(DrawMode mode, float x, float y, float a, float b, int points,
                      const Color& color);
 
@@ -109,7 +147,7 @@ namespace love
             this->transformStack.back().SetIdentity();
         }
 
-        Matrix4& GetTransform()
+        Affine2D& GetTransform()
         {
             return this->transformStack.back();
         }
@@ -265,11 +303,36 @@ namespace love
         }
 
       private:
-        int CalculateEllipsePoints(float rx, float ry);
+        struct LineBatch
+        {
+            int first;
+            size_t count;
+            float pixelSize;
+            bool smooth;
+            bool ramp;
+        };
+
+        LineBatch BeginLines();
+
+        bool AppendLine(LineBatch& batch, std::span<Vector2> points, const Color& color,
+                        float width, LineJoin join);
+
+        void EndLines(const LineBatch& batch);
+
+        C3D_Tex* GetLineRamp();
+
+        /* fewest points that keep an ellipse within ELLIPSE_PIXEL_ERROR at the pixel scale */
+        int CalculateEllipsePoints(float rx, float ry) const;
 
         std::vector<DisplayState> state;
-        std::vector<Matrix4> transformStack;
+        std::vector<Affine2D> transformStack;
         std::vector<double> pixelScaleStack;
         std::vector<StackType> stackTypeStack;
+
+        love::Polyline::Scratch polylineScratch;
+        Triangulator triangulator;
+
+        C3D_Tex lineRamp;
+        bool lineRampCreated = false;
     };
 } // namespace love
\ No newline at end of file
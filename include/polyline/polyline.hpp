@@ -1,11 +1,14 @@
 #pragma once
 
+#include "affine2d.hpp"
 #include "color.hpp"
 #include "math.hpp"
+#include "matrix.hpp"
 #include "vector.hpp"
 #include "vertex.hpp"
 
 // C++
+#include <array>
 #include <string.h>
 #include <vector>
 
@@ -24,18 +27,37 @@ namespace love
       public:
         static constexpr float LINES_PARALLEL_EPS = 0.05f;
 
+        /** Size of the alpha ramp texture sampled by ramp antialiased lines. */
+        static constexpr int RAMP_SIZE = 8;
+
+        /*
+        ** Working memory for tessellation. It keeps its capacity between lines,
+        ** so once it has grown to fit the largest line nothing else is allocated.
+        ** The vertices of a rendered line live here until the next render with
+        ** the same scratch; use one per thread to tessellate concurrently.
+        */
+        struct Scratch
+        {
+            std::vector<Vector2> anchors;
+            std::vector<Vector2> normals;
+            std::vector<Vector2> vertices;
+        };
+
         Polyline(vertex::TriangleIndexMode mode = vertex::TRIANGLE_STRIP) :
             vertices(nullptr),
             overdraw(nullptr),
             vertex_count(0),
             overdraw_vertex_count(0),
             triangle_mode(mode),
-            overdraw_vertex_start(0)
+            overdraw_vertex_start(0),
+            ramp_width(0.0f)
         {}
 
-        virtual ~Polyline();
+        virtual ~Polyline()
+        {}
 
         /**
+         * @param scratch       Storage for the tessellated vertices.
          * @param vertices      Vertices defining the core line segments
          * @param count         Number of vertices
          * @param size_hint     Expected number of vertices of the rendering sleeve around the
@@ -43,20 +65,73 @@ namespace love
          * @param halfwidth     linewidth / 2.
          * @param pixel_size    Dimension of one pixel on the screen in world coordinates.
          * @param draw_overdraw Fake antialias the line.
+         * @param draw_ramp     Antialias by widening the line by a pixel and fading its
+         * edges with the ramp texture instead. Takes precedence over draw_overdraw.
          */
-        void render(const Vector2* vertices, size_t count, size_t size_hint, float halfwidth,
-                    float pixel_size, bool draw_overdraw);
+        void render(Scratch& scratch, const Vector2* vertices, size_t count, size_t size_hint,
+                    float halfwidth, float pixel_size, bool draw_overdraw,
+                    bool draw_ramp = false);
 
-        /** Draws the line on the screen
+        /** Draws the line on the screen, in draws of fewer than 65k vertices.
+         *
+         * Each draw reserves its own room in the frame vertex buffer, so a line
+         * longer than what is left of it this frame is cut short there.
          */
         void draw(Graphics* gfx);
 
+        /** Number of vertices written by write_vertices, including overdraw.
+         */
+        size_t get_total_vertex_count() const;
+
+        /** Alpha of texel (x, y) of the ramp texture, in image rows.
+         *
+         * The texture is opaque except for its first column and last row, so
+         * with linear filtering and clamping, alpha ramps up over the first
+         * pixel of either texture coordinate and stays opaque past it.
+         */
+        static uint8_t get_ramp_texel(int x, int y)
+        {
+            return (x > 0 && y < RAMP_SIZE - 1) ? 0xFF : 0x00;
+        }
+
+        bool is_ramp() const
+        {
+            return ramp_width > 0.0f;
+        }
+
+        /** Writes vertices [start, start + count) of the rendered line, which
+         * is one triangle strip, as final vertices.
+         *
+         * @param out       Room for @count vertices.
+         * @param transform Applied to every vertex.
+         * @param color     Color of the core line; overdraw fades out from it.
+         * @param start     First vertex to write, below get_total_vertex_count().
+         * @param count     Vertices to write.
+         */
+        void write_vertices(vertex::Vertex* out, const Affine2D& transform, const Color& color,
+                            size_t start, size_t count);
+
+        /** Same as above without colors, for lines without overdraw, which are
+         * one color throughout.
+         */
+        void write_vertices(vertex::FixedColorVertex* out, const Affine2D& transform,
+                            size_t start, size_t count);
+
       protected:
         virtual void calc_overdraw_vertex_count(bool is_looping);
         virtual void render_overdraw(const std::vector<Vector2>& normals, float pixel_size,
                                      bool is_looping);
         virtual void fill_color_array(Color constant_color, Color* colors, int count);
 
+        /** Whether vertex @index lies on the left edge of the sleeve. */
+        virtual bool on_left_edge(size_t index) const
+        {
+            return (index & 1) == 0;
+        }
+
+        /** Ramp texture coordinates of vertex @index, zero unless ramp antialiased. */
+        std::array<float, 2> get_ramp_texcoord(size_t index) const;
+
         /** Calculate line boundary points.
          *
          * @param[out]    anchors       Anchor points defining the core line.
@@ -78,6 +153,7 @@ namespace love
         size_t overdraw_vertex_count;
         vertex::TriangleIndexMode triangle_mode;
         size_t overdraw_vertex_start;
+        float ramp_width; //< sleeve width in pixels when ramp antialiased, else 0
 
     }; // Polyline
 } // namespace love
@@ -11,10 +11,11 @@ namespace love
     class MiterJoinPolyline : public Polyline
     {
       public:
-        void render(const Vector2* vertices, size_t count, float halfwidth, float pixel_size,
-                    bool draw_overdraw)
+        void render(Scratch& scratch, const Vector2* vertices, size_t count, float halfwidth,
+                    float pixel_size, bool draw_overdraw, bool draw_ramp = false)
         {
-            Polyline::render(vertices, count, 2 * count, halfwidth, pixel_size, draw_overdraw);
+            Polyline::render(scratch, vertices, count, 2 * count, halfwidth, pixel_size,
+                             draw_overdraw, draw_ramp);
         }
 
       protected:
@@ -16,10 +16,11 @@ namespace love
         NoneJoinPolyline() : Polyline(vertex::TRIANGLE_QUADS)
         {}
 
-        void render(const Vector2* vertices, size_t count, float halfwidth, float pixel_size,
-                    bool draw_overdraw)
+        void render(Scratch& scratch, const Vector2* vertices, size_t count, float halfwidth,
+                    float pixel_size, bool draw_overdraw, bool draw_ramp = false)
         {
-            Polyline::render(vertices, count, 4 * count - 4, halfwidth, pixel_size, draw_overdraw);
+            Polyline::render(scratch, vertices, count, 4 * count - 4, halfwidth, pixel_size,
+                             draw_overdraw, draw_ramp);
 
             // discard the first and last two vertices. (these are redundant)
             for (size_t i = 0; i < vertex_count - 4; ++i)
@@ -39,6 +40,12 @@ namespace love
         void render_overdraw(const std::vector<Vector2>& normals, float pixel_size,
                              bool is_looping) override;
         void fill_color_array(Color constant_color, Color* colors, int count) override;
+
+        // quads run q-, q+, r+, r- once the first two vertices are discarded
+        bool on_left_edge(size_t index) const override
+        {
+            return ((index + 1) & 2) != 0;
+        }
         void renderEdge(std::vector<Vector2>& anchors, std::vector<Vector2>& normals, Vector2& s,
                         float& len_s, Vector2& ns, const Vector2& q, const Vector2& r,
                         float hw) override;
@@ -2,8 +2,10 @@
 
 #include <3ds.h>
 
+#include "fontindex.hpp"
 #include "glyphdata.hpp"
 #include "object.hpp"
+#include "strongreference.hpp"
 
 #include <utf8.h>
 
@@ -26,6 +28,11 @@ namespace love
 
         Rasterizer(const void* data, size_t dataSize, float size);
 
+        Rasterizer(const char* path, float size);
+
+        /* draws @base's face at another size, without loading it again */
+        Rasterizer(Rasterizer* base, float size);
+
         virtual ~Rasterizer();
 
         static inline Type type = Type("Rasterizer", &Object::type);
@@ -45,11 +52,30 @@ namespace love
             return this->face;
         }
 
+        /*
+        ** FINF fontType written by tools/bcfnt2sdf. Such fonts store a signed
+        ** distance per texel instead of coverage, see TEXENV_MODE_DISTANCE_FIELD.
+        */
+        static constexpr uint8_t FONT_TYPE_DISTANCE_FIELD = 0x44;
+
+        bool IsDistanceField() const
+        {
+            return fontGetInfo(this->face)->fontType == FONT_TYPE_DISTANCE_FIELD;
+        }
+
         const float GetScale() const
         {
             return this->scale;
         }
 
+        /* same as GetGlyphData, without allocating a GlyphData */
+        void GetGlyphMetrics(uint32_t glyph, GlyphData::GlyphMetrics& metrics,
+                             GlyphData::GlyphSheetInfo& info) const;
+
+        /* metrics at @scale instead of this Rasterizer's size, 1 gives font units */
+        void GetGlyphMetrics(uint32_t glyph, float scale, GlyphData::GlyphMetrics& metrics,
+                             GlyphData::GlyphSheetInfo& info) const;
+
         GlyphData* GetGlyphData(uint32_t glyph) const;
 
         GlyphData* GetGlyphData(std::string_view text) const;
@@ -61,10 +87,22 @@ namespace love
         const float GetKerning(uint32_t left, uint32_t right) const;
 
       private:
+        int GetGlyphIndex(uint32_t glyph) const;
+
+        const FontIndex& GetIndex() const
+        {
+            return this->base ? this->base->index : this->index;
+        }
+
+        void SetFileMetrics(float size);
+
         int glyphCount;
         float scale;
 
         FontMetrics metrics;
         CFNT_s* face;
+        FontIndex index;
+
+        StrongReference<Rasterizer> base;
     };
 } // namespace love
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "color.hpp"
 #include "drawcommand.hpp"
 #include "framebuffer.hpp"
+#include "math.hpp"
 
 namespace love
 {
@@ -23,6 +24,15 @@ namespace love
             return renderer;
         }
 
+        /*
+        ** Counts started frames. With C3D_FRAME_SYNCDRAW, anything the GPU read
+        ** during an earlier frame is free to be overwritten once a frame starts.
+        */
+        static uint32_t GetFrame()
+        {
+            return Renderer::frame;
+        }
+
         Framebuffer* GetCurrent() const
         {
             return this->current;
@@ -36,15 +46,58 @@ namespace love
 
         bool Render(DrawCommand& command);
 
+        /*
+        ** Reserves @count vertices in this frame's vertex buffer.
+        ** @first receives the index of the first vertex, for DrawCommand.
+        ** Returns nullptr when the buffer is full.
+        */
+        Vertex* GetVertices(size_t count, int& first);
+
+        /*
+        ** Same as GetVertices, for draws whose vertices all share one color,
+        ** which the DrawCommand's fixedColor supplies instead of each vertex.
+        */
+        FixedColorVertex* GetFixedColorVertices(size_t count, int& first);
+
+        /*
+        ** Reserves @count indices in this frame's index buffer, for a
+        ** DrawCommand's indices. They index the frame vertex buffer from its
+        ** start, not from a command's first vertex. Returns nullptr when full.
+        */
+        uint16_t* GetIndices(size_t count);
+
+        static constexpr size_t MAX_VERTICES = LOVE_UINT16_MAX + 1;
+
+        /* enough to triangulate a frame's worth of polygon vertices */
+        static constexpr size_t MAX_INDICES = MAX_VERTICES * 3;
+
       private:
         bool CheckHandle(C3D_Tex* texture);
 
+        /* attribute id of the fixed color, after the position and texcoord loaders */
+        static constexpr int FIXED_COLOR_ATTRIBUTE = 2;
+
+        void SetFixedColorLayout(bool fixedColor);
+
         std::array<Framebuffer, 0x03> framebuffers;
         Framebuffer* current;
         C3D_Tex* currentTexture;
 
         bool inFrame;
 
-        std::vector<std::shared_ptr<DrawBuffer>> commands;
+        DrawBuffer vertices;
+        size_t vertexCount;
+
+        DrawBuffer fixedColorVertices;
+        size_t fixedColorVertexCount;
+
+        C3D_AttrInfo vertexAttributes;
+        C3D_AttrInfo fixedColorAttributes;
+        bool fixedColorLayout;
+
+        uint16_t* indices;
+        size_t indexCount;
+
+        static inline uint32_t frame = 0;
     };
 } // namespace love
\ No newline at end of file
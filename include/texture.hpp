@@ -5,6 +5,7 @@
 
 #include "graphics.hpp"
 #include "object.hpp"
+#include "pixelformat.hpp"
 #include "quad.hpp"
 
 namespace love
@@ -18,20 +19,67 @@ namespace love
 
         static inline Type type = Type("Texture", &Object::type);
 
-        C3D_Tex* GetTexture()
+        /* reloads the texture if TextureCache evicted it */
+        C3D_Tex* GetTexture();
+
+        /* false if the file could not be read or imported */
+        bool IsValid() const
+        {
+            return this->valid;
+        }
+
+        /* false while evicted by TextureCache */
+        bool IsResident() const
+        {
+            return this->texture != nullptr;
+        }
+
+        const std::string& GetPath() const
+        {
+            return this->path;
+        }
+
+        /* PIXELFORMAT_UNKNOWN for the 4-bit formats, which have no equivalent */
+        PixelFormat GetPixelFormat() const
+        {
+            return this->format;
+        }
+
+        /* bytes of texture memory used while resident, mipmaps included */
+        size_t GetSize() const
+        {
+            return this->size;
+        }
+
+        /* the last frame the texture was drawn in, or loaded in by TextureCache */
+        uint32_t GetLastFrame() const
         {
-            return this->texture;
+            return this->lastFrame;
         }
 
         ~Texture();
 
       private:
+        friend class TextureCache;
+
+        bool Load();
+
+        void Unload();
+
+        std::string path;
+
         int width;
         int height;
 
         C3D_Tex* texture;
         Quad* quad;
 
+        PixelFormat format;
+        size_t size;
+
+        uint32_t lastFrame;
+        bool cached; //< owned by TextureCache, which reloads it after eviction
+
         bool valid;
     };
-} // namespace love
\ No newline at end of file
+} // namespace love
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "strongreference.hpp"
+#include "texture.hpp"
+
+#include <string>
+#include <unordered_map>
+
+namespace love
+{
+    /*
+    ** Shares one Texture per asset path and keeps the texture memory of the ones
+    ** it loaded within a budget. Once over it, the least recently drawn textures
+    ** are unloaded, never one drawn this frame, and reload from their path the
+    ** next time they are drawn. Textures stay alive while anything references
+    ** them; the cache only holds them weakly. Use it from the render thread.
+    */
+    class TextureCache
+    {
+      public:
+        static constexpr size_t DEFAULT_BUDGET = 0x1000000;
+
+        static TextureCache& Instance()
+        {
+            static TextureCache cache;
+            return cache;
+        }
+
+        /* the texture at @path, loading it if nothing references it yet */
+        StrongReference<Texture> Get(const std::string& path);
+
+        /* evicts right away if the new budget is already exceeded */
+        void SetBudget(size_t bytes);
+
+        size_t GetBudget() const
+        {
+            return this->budget;
+        }
+
+        /* bytes used by the resident textures of the cache */
+        size_t GetResidentSize() const
+        {
+            return this->resident;
+        }
+
+        size_t GetTextureCount() const
+        {
+            return this->textures.size();
+        }
+
+      private:
+        friend class Texture;
+
+        TextureCache();
+
+        void Reload(Texture* texture);
+
+        void Remove(Texture* texture);
+
+        /* unloads textures other than @keep until the budget is met */
+        void Evict(const Texture* keep);
+
+        std::unordered_map<std::string, Texture*> textures;
+
+        size_t budget;
+        size_t resident;
+    };
+} // namespace love
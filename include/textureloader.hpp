@@ -0,0 +1,159 @@
+#pragma once
+
+#include <3ds.h>
+
+#include "object.hpp"
+#include "strongreference.hpp"
+#include "texture.hpp"
+
+#include <atomic>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace love
+{
+    /*
+    ** Loads textures on a worker thread, so reading and importing them does
+    ** not stall the frame. Requests are served highest priority first, then in
+    ** the order they were made. The worker finishes a texture completely before
+    ** publishing it, so polling a request from the render thread takes no lock.
+    */
+    class TextureLoader
+    {
+      public:
+        enum Priority
+        {
+            PRIORITY_LOW,
+            PRIORITY_NORMAL,
+            PRIORITY_HIGH
+        };
+
+        class Request : public Object
+        {
+          public:
+            static inline Type type = Type("TextureLoader::Request", &Object::type);
+
+            enum State
+            {
+                STATE_PENDING,
+                STATE_LOADING,
+                STATE_DONE,
+                STATE_FAILED,
+                STATE_CANCELED
+            };
+
+            State GetState() const
+            {
+                return this->state.load(std::memory_order_acquire);
+            }
+
+            /* done, failed or canceled; the request will not change any more */
+            bool IsFinished() const
+            {
+                return this->GetState() >= STATE_DONE;
+            }
+
+            /* the loaded texture, nullptr until the request is done */
+            Texture* GetTexture() const
+            {
+                if (this->GetState() != STATE_DONE)
+                    return nullptr;
+
+                return this->texture.Get();
+            }
+
+            const std::string& GetPath() const
+            {
+                return this->path;
+            }
+
+            Priority GetPriority() const
+            {
+                return this->priority;
+            }
+
+            /* returns false if the worker already started on the request */
+            bool Cancel()
+            {
+                State expected = STATE_PENDING;
+                return this->state.compare_exchange_strong(expected, STATE_CANCELED);
+            }
+
+          private:
+            friend class TextureLoader;
+
+            Request(const std::string& path, Priority priority);
+
+            /* loads the texture if nobody else started to; false otherwise */
+            bool Run();
+
+            std::string path;
+            Priority priority;
+
+            StrongReference<Texture> texture;
+            std::atomic<State> state;
+        };
+
+        static constexpr size_t STACK_SIZE = 0x8000;
+
+        static TextureLoader& Instance()
+        {
+            static TextureLoader loader;
+            return loader;
+        }
+
+        ~TextureLoader();
+
+        /* queues @path to load in the background */
+        StrongReference<Request> Load(const std::string& path, Priority priority = PRIORITY_NORMAL);
+
+        /*
+        ** Blocks until @request is finished and returns its texture, nullptr if
+        ** it failed or was canceled. A request the worker has not reached yet is
+        ** loaded on the calling thread instead of waiting for its turn.
+        */
+        Texture* Wait(Request* request);
+
+        /* requests not yet started by the worker, canceled ones included */
+        size_t GetPendingCount();
+
+      private:
+        TextureLoader();
+
+        struct Entry
+        {
+            Priority priority;
+            uint64_t sequence;
+            StrongReference<Request> request;
+
+            /* std::priority_queue pops the greatest entry */
+            bool operator<(const Entry& other) const
+            {
+                if (this->priority != other.priority)
+                    return this->priority < other.priority;
+
+                return this->sequence > other.sequence;
+            }
+        };
+
+        void Run();
+
+        StrongReference<Request> Pop();
+
+        void Lock();
+
+        void Unlock();
+
+        std::priority_queue<Entry> queue;
+        uint64_t sequence;
+
+        std::atomic<bool> quit;
+
+        static void ThreadMain(void* loader);
+
+        Thread thread;
+        LightLock lock;
+        LightSemaphore pending; //< counts queued entries, plus one to quit
+    };
+} // namespace love
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "font.hpp"
+#include "strongreference.hpp"
+
+#include <string_view>
+#include <vector>
+
+namespace love
+{
+    /*
+    ** Keeps wrapped line state for text that changes a little at a time
+    ** (chat logs, consoles, text inputs). Edits only re-wrap from the line
+    ** before the edit until the new line starts line up with the old ones again.
+    ** Lines are spans into GetCodepoints(), nothing is copied per line.
+    */
+    class TextWrap
+    {
+      public:
+        TextWrap(Font* font, float wraplimit);
+
+        void SetWrapLimit(float wraplimit);
+
+        float GetWrapLimit() const
+        {
+            return this->wraplimit;
+        }
+
+        void Set(std::string_view text);
+
+        void Append(std::string_view text);
+
+        /* replaces @count codepoints at @start with @text */
+        void Replace(size_t start, size_t count, std::string_view text);
+
+        void Erase(size_t start, size_t count);
+
+        void Clear();
+
+        const Font::Codepoints& GetCodepoints() const
+        {
+            return this->codepoints;
+        }
+
+        const std::vector<Font::WrapLine>& GetLines() const
+        {
+            return this->lines;
+        }
+
+      private:
+        static void Decode(std::string_view text, Font::Codepoints& out);
+
+        void Rewrap(size_t start, size_t oldEnd, size_t newEnd);
+
+        StrongReference<Font> font;
+        float wraplimit;
+
+        Font::Codepoints codepoints;
+        std::vector<Font::WrapLine> lines;
+        std::vector<Font::WrapLine> previous;
+    };
+} // namespace love
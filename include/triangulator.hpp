@@ -0,0 +1,130 @@
+#pragma once
+
+#include "vector.hpp"
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace love
+{
+    /*
+    ** Turns simple polygons, convex or not, into indexed triangle lists.
+    ** Convex polygons become a fan without further work. Everything else is
+    ** ear clipped, with reflex vertices looked up along a z-order curve once
+    ** the polygon is large, and the result is cached by the polygon's points.
+    */
+    class Triangulator
+    {
+      public:
+        /* polygons with more points than this get their ears tested through the z-order index */
+        static constexpr size_t HASH_THRESHOLD = 80;
+
+        static constexpr size_t MAX_CACHE_ENTRIES = 32;
+
+        Triangulator();
+
+        /*
+        ** Triangulates @points, in either winding. The returned indices point into
+        ** @points, three per triangle, and stay valid until the next call.
+        ** Returns nothing for polygons of fewer than three points or more than
+        ** UINT16_MAX + 1 points.
+        */
+        std::span<const uint16_t> Triangulate(std::span<const Vector2> points);
+
+        static bool IsConvex(std::span<const Vector2> points);
+
+        void ClearCache()
+        {
+            this->cache.clear();
+        }
+
+      private:
+        struct Node
+        {
+            float x;
+            float y;
+            uint32_t z; //< z-order of the point, 0 until indexed
+            int index;  //< into the polygon's points
+
+            int prev;
+            int next;
+            int prevZ;
+            int nextZ;
+
+            bool reflex;
+        };
+
+        struct CacheEntry
+        {
+            std::vector<Vector2> points;
+            std::vector<uint16_t> indices;
+            uint64_t lastUse;
+        };
+
+        static uint64_t Hash(std::span<const Vector2> points);
+
+        void Fan(size_t count);
+
+        void EarClip(std::span<const Vector2> points);
+
+        /* ear clipping steps, after the earcut algorithm by Mapbox */
+
+        int LinkedList(std::span<const Vector2> points);
+
+        int InsertNode(int index, const Vector2& point, int last);
+
+        void RemoveNode(int node);
+
+        int FilterPoints(int start, int end = -1);
+
+        void EarcutLinked(int ear, int pass);
+
+        int CountReflex(int start);
+
+        int UpdateReflex(int node);
+
+        void FanLinked(int start);
+
+        bool IsEar(int ear) const;
+
+        bool IsEarHashed(int ear) const;
+
+        int CureLocalIntersections(int start);
+
+        void SplitEarcut(int start);
+
+        int SplitPolygon(int a, int b);
+
+        bool IsValidDiagonal(int a, int b) const;
+
+        bool IntersectsPolygon(int a, int b) const;
+
+        bool LocallyInside(int a, int b) const;
+
+        bool MiddleInside(int a, int b) const;
+
+        float Area(int p, int q, int r) const;
+
+        bool Equals(int a, int b) const;
+
+        bool Intersects(int p1, int q1, int p2, int q2) const;
+
+        uint32_t ZOrder(float x, float y) const;
+
+        void IndexCurve(int start);
+
+        int SortLinked(int list);
+
+        std::vector<Node> nodes;
+        std::vector<uint16_t> indices;
+
+        float minX;
+        float minY;
+        float invSize; //< 0 when not using the z-order index
+
+        std::unordered_map<uint64_t, CacheEntry> cache;
+        uint64_t uses;
+    };
+} // namespace love
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string_view>
+
+namespace love
+{
+    namespace unicode
+    {
+        /*
+        ** Validates UTF-8 text, skipping ASCII runs a machine word at a time.
+        ** Returns the byte offset of the first invalid sequence, or text.size().
+        */
+        size_t FindInvalid(std::string_view text);
+
+        /*
+        ** Decodes already validated UTF-8 text without further checks.
+        ** @param out: must hold at least text.size() codepoints
+        ** Returns the number of codepoints written.
+        */
+        size_t DecodeUnchecked(std::string_view text, uint32_t* out);
+    } // namespace unicode
+} // namespace love
@@ -34,6 +34,13 @@ namespace vertex
         std::array<float, 2> texcoord;
     };
 
+    /* a vertex of a draw that gives every vertex the same color through a fixed attribute */
+    struct FixedColorVertex
+    {
+        std::array<float, 3> position;
+        std::array<float, 2> texcoord;
+    };
+
     static inline GPU_Primitive_t GetMode(PrimitiveType mode)
     {
         switch (mode)
@@ -56,6 +63,8 @@ namespace vertex
 
     static constexpr size_t VERTEX_SIZE = sizeof(Vertex);
 
+    static constexpr size_t FIXED_COLOR_VERTEX_SIZE = sizeof(FixedColorVertex);
+
     static inline std::array<uint16_t, 2> Normalize(const love::Vector2& in)
     {
         return { normto16t(in.x), normto16t(in.y) };
@@ -0,0 +1,91 @@
+#include "affine2d.hpp"
+
+#include <cmath>
+
+using namespace love;
+
+Affine2D::Affine2D(const Matrix4& matrix)
+{
+    const auto& elements = matrix.GetElements();
+
+    this->a  = elements.r[0].x;
+    this->b  = elements.r[1].x;
+    this->c  = elements.r[0].y;
+    this->d  = elements.r[1].y;
+    this->tx = elements.r[0].w;
+    this->ty = elements.r[1].w;
+
+    if (this->a == 1.0f && this->b == 0.0f && this->c == 0.0f && this->d == 1.0f)
+    {
+        const bool moves     = this->tx != 0.0f || this->ty != 0.0f;
+        this->classification = moves ? TRANSFORM_TRANSLATION : TRANSFORM_IDENTITY;
+    }
+    else if (this->b == 0.0f && this->c == 0.0f)
+        this->classification = TRANSFORM_SCALE;
+    else if (matrix.IsAffine2DTransform())
+        this->classification = TRANSFORM_RIGID;
+    else
+        this->classification = TRANSFORM_AFFINE;
+}
+
+void Affine2D::Rotate(float r)
+{
+    if (r == 0.0f)
+        return;
+
+    const float cosine = cosf(r);
+    const float sine   = sinf(r);
+
+    const float a = this->a * cosine + this->c * sine;
+    const float b = this->b * cosine + this->d * sine;
+
+    this->c = this->c * cosine - this->a * sine;
+    this->d = this->d * cosine - this->b * sine;
+    this->a = a;
+    this->b = b;
+
+    this->classification = Combine(this->classification, TRANSFORM_RIGID);
+}
+
+void Affine2D::Shear(float kx, float ky)
+{
+    if (kx == 0.0f && ky == 0.0f)
+        return;
+
+    const float a = this->a + this->c * ky;
+    const float b = this->b + this->d * ky;
+
+    this->c += this->a * kx;
+    this->d += this->b * kx;
+    this->a = a;
+    this->b = b;
+
+    this->classification = TRANSFORM_AFFINE;
+}
+
+Affine2D Affine2D::operator*(const Affine2D& m) const
+{
+    return Affine2D(this->a * m.a + this->c * m.b, this->b * m.a + this->d * m.b,
+                    this->a * m.c + this->c * m.d, this->b * m.c + this->d * m.d,
+                    this->a * m.tx + this->c * m.ty + this->tx,
+                    this->b * m.tx + this->d * m.ty + this->ty,
+                    Combine(this->classification, m.classification));
+}
+
+Affine2D Affine2D::Inverse() const
+{
+    const float determinant = this->a * this->d - this->b * this->c;
+
+    if (determinant == 0.0f)
+        return Affine2D();
+
+    const float inverse = 1.0f / determinant;
+
+    const float a = this->d * inverse;
+    const float b = -this->b * inverse;
+    const float c = -this->c * inverse;
+    const float d = this->a * inverse;
+
+    return Affine2D(a, b, c, d, -(a * this->tx + c * this->ty), -(b * this->tx + d * this->ty),
+                    this->classification);
+}
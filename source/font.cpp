@@ -3,6 +3,7 @@
 #include "drawcommand.hpp"
 #include "graphics.hpp"
 #include "renderer.hpp"
+#include "unicode.hpp"
 
 #include <utf8.h>
 
@@ -11,60 +12,19 @@ using namespace vertex;
 
 Font::Font(Rasterizer* rasterizer) :
     rasterizers({ rasterizer }),
-    useSpacesAsTab(false),
     scale(rasterizer->GetScale()),
-    inited(false)
+    sheetSwitches(0)
 {
     this->height = rasterizer->GetHeight();
-
-    if (!rasterizer->HasGlyph(Font::TAB_GLYPH))
-        this->useSpacesAsTab = true;
-
     this->LoadVolatile();
 }
 
 bool Font::LoadVolatile()
 {
-    this->glyphs.clear();
-    this->textures.clear();
-    this->CreateTexture();
-
+    this->table = GlyphTable::Get(this->rasterizers[0]);
     return true;
 }
 
-void Font::CreateTexture()
-{
-    if (this->inited)
-        return;
-
-    auto* font            = this->rasterizers[0]->GetFont();
-    const auto* glyphInfo = fontGetGlyphInfo(font);
-
-    this->textures.reserve(glyphInfo->nSheets);
-
-    const auto MIN_MAG = GPU_TEXTURE_MAG_FILTER(GPU_LINEAR) | GPU_TEXTURE_MIN_FILTER(GPU_LINEAR);
-
-    const auto WRAP =
-        GPU_TEXTURE_WRAP_S(GPU_CLAMP_TO_BORDER) | GPU_TEXTURE_WRAP_T(GPU_CLAMP_TO_BORDER);
-
-    for (size_t index = 0; index < glyphInfo->nSheets; index++)
-    {
-        this->textures.push_back(C3D_Tex {});
-
-        C3D_Tex* texture  = &this->textures[index];
-        texture->data     = fontGetGlyphSheetTex(font, index);
-        texture->fmt      = (GPU_TEXCOLOR)glyphInfo->sheetFmt;
-        texture->size     = glyphInfo->sheetSize;
-        texture->width    = glyphInfo->sheetWidth;
-        texture->height   = glyphInfo->sheetHeight;
-        texture->param    = MIN_MAG | WRAP;
-        texture->border   = 0;
-        texture->lodParam = 0;
-    }
-
-    this->inited = true;
-}
-
 void Font::GetCodepointsFromString(const ColoredStrings& strings, ColoredCodepoints& out)
 {
     if (strings.empty())
@@ -93,121 +53,115 @@ void Font::GetCodepointsFromString(const ColoredStrings& strings, ColoredCodepoi
 
 void Font::GetCodepointsFromString(std::string_view text, Codepoints& out)
 {
-    out.reserve(text.size());
+    if (unicode::FindInvalid(text) != text.size())
+        throw love::Exception("UTF-8 decoding error: Invalid UTF-8");
 
-    try
-    {
-        Utf8Iterator start(text.begin(), text.begin(), text.end());
-        Utf8Iterator end(text.end(), text.begin(), text.end());
+    /* decoded text never has more codepoints than bytes */
+    const size_t start = out.size();
+    out.resize(start + text.size());
 
-        while (start != end)
-        {
-            auto glyph = *start++;
-            out.push_back(glyph);
-        }
-    }
-    catch (utf8::exception& exception)
-    {
-        throw love::Exception("UTF-8 decoding error: %s", exception.what());
-    }
+    const size_t count = unicode::DecodeUnchecked(text, out.data() + start);
+    out.resize(start + count);
 }
 
-GlyphData* Font::GetRasterizerGlyphData(uint32_t glyph)
+void Font::Prewarm(std::string_view charset)
 {
-    if (glyph == Font::TAB_GLYPH && this->useSpacesAsTab)
-    {
-        auto* space = this->rasterizers[0]->GetGlyphData(Font::SPACE_GLYPH);
-
-        GlyphData::GlyphMetrics metrics {};
-        metrics.advance  = space->GetAdvance() * Font::SPACES_PER_TAB;
-        metrics.bearingX = space->GetBearingX();
-        metrics.bearingY = space->GetBearingY();
-
-        GlyphData::GlyphSheetInfo info {};
-        info.index  = space->GetSheetIndex();
-        info.top    = space->GetTop();
-        info.left   = space->GetLeft();
-        info.right  = space->GetRight();
-        info.bottom = space->GetBottom();
-
-        space->Release();
-        return new GlyphData(glyph, metrics, info);
-    }
+    Codepoints codepoints {};
+    Font::GetCodepointsFromString(charset, codepoints);
+
+    this->Prewarm(codepoints);
+}
+
+void Font::Prewarm(const std::vector<std::string>& strings)
+{
+    Codepoints codepoints {};
+
+    for (const auto& string : strings)
+        Font::GetCodepointsFromString(string, codepoints);
+
+    this->Prewarm(codepoints);
+}
+
+void Font::Prewarm(Codepoints& codepoints)
+{
+    std::sort(codepoints.begin(), codepoints.end());
+    codepoints.erase(std::unique(codepoints.begin(), codepoints.end()), codepoints.end());
 
-    for (const auto& rasterizer : this->rasterizers)
+    /* size the table once instead of rehashing as glyphs trickle in */
+    this->table->Reserve(codepoints.size());
+
+    for (const auto codepoint : codepoints)
     {
-        if (rasterizer->HasGlyph(glyph))
-            return rasterizer->GetGlyphData(glyph);
+        if (codepoint == Font::NEWLINE_GLYPH || codepoint == Font::CARRIAGE_GLYPH)
+            continue;
+
+        this->table->Find(codepoint);
     }
+}
 
-    return this->rasterizers[0]->GetGlyphData(glyph);
+bool Font::SaveGlyphCache(const char* path) const
+{
+    return this->table->Save(path);
 }
 
-const Font::Glyph& Font::AddGlyph(uint32_t glyph)
+bool Font::LoadGlyphCache(const char* path)
 {
-    StrongReference<GlyphData> data(this->GetRasterizerGlyphData(glyph));
+    return this->table->Load(path);
+}
 
-    auto width  = (float)data->GetWidth();
-    auto height = (float)data->GetHeight();
+const Font::Glyph& Font::FindGlyph(uint32_t glyph, bool draw)
+{
+    return this->table->Find(glyph, draw);
+}
 
-    Glyph _glyph {};
+/*
+** Lays out one contiguous range of vertices per glyph sheet, in sheet order,
+** so that every sheet is drawn exactly once. Glyphs sharing a sheet keep their
+** relative order; only overlapping glyphs on different sheets can draw in a
+** different order. @total receives the number of vertices to reserve.
+*/
+std::vector<Font::DrawCommand> Font::ReserveSheets(const Codepoints& codepoints, size_t& total)
+{
+    std::vector<DrawCommand> commands {};
+    this->sheetCounts.assign(this->table->GetSheetCount(), 0);
 
-    _glyph.texture = nullptr;
-    _glyph.spacing = std::floor(data->GetAdvance());
-    std::fill_n(_glyph.vertices.data(), 6, vertex::Vertex {});
+    int previousSheet   = -1;
+    this->sheetSwitches = 0;
 
-    if (width > 0 && height > 0)
+    for (const auto glyph : codepoints)
     {
-        _glyph.sheet   = data->GetSheetIndex();
-        _glyph.texture = &this->textures[_glyph.sheet];
+        if (glyph == Font::NEWLINE_GLYPH || glyph == Font::CARRIAGE_GLYPH)
+            continue;
 
-        const auto offset = 1.0f;
-        const auto color  = Color(Color::WHITE).array();
+        const auto& glyphData = this->FindGlyph(glyph, true);
 
-        const auto left   = data->GetLeft();
-        const auto top    = data->GetTop();
-        const auto right  = data->GetRight();
-        const auto bottom = data->GetBottom();
+        if (glyphData.texture == nullptr)
+            continue;
 
-        // clang-format off
-        const std::array<Vertex, 0x06> vertices = 
-        {
-            /*        x        y       z                u      v      */
-            Vertex {{ 0,       0,      0.0f }, color, { left,  top       }},
-            Vertex {{ 0,       height, 0.0f }, color, { left,  bottom    }},
-            Vertex {{ width,   height, 0.0f }, color, { right, bottom    }},
-            Vertex {{ width,   height, 0.0f }, color, { right, bottom    }},
-            Vertex {{ width,   0,      0.0f }, color, { right, top       }},
-            Vertex {{ 0,       0,      0.0f }, color, { left,  top       }}
-        };
-        // clang-format on
-
-        for (size_t index = 0; index < 0x06; index++)
-        {
-            _glyph.vertices[index] = vertices[index];
+        if (previousSheet != -1 && glyphData.sheet != previousSheet)
+            this->sheetSwitches++;
 
-            _glyph.vertices[index].position[0] += data->GetBearingX();
-            _glyph.vertices[index].position[1] += data->GetBearingY();
-        }
+        previousSheet = glyphData.sheet;
+        this->sheetCounts[glyphData.sheet] += 6;
     }
 
-    this->glyphs[glyph] = _glyph;
-    return this->glyphs[glyph];
-}
+    total = 0;
 
-const Font::Glyph& Font::FindGlyph(uint32_t glyph)
-{
-    const auto iterator = this->glyphs.find(glyph);
+    for (int sheet = 0; sheet < (int)this->sheetCounts.size(); sheet++)
+    {
+        const int count = this->sheetCounts[sheet];
 
-    if (iterator != this->glyphs.end())
-        return iterator->second;
+        /* reuse the counts as the index of each sheet's command */
+        this->sheetCounts[sheet] = (int)commands.size();
 
-    return this->AddGlyph(glyph);
-}
+        if (count == 0)
+            continue;
 
-static bool drawSort(const Font::DrawCommand& a, const Font::DrawCommand& b)
-{
-    return a.sheet < b.sheet;
+        commands.push_back({ this->table->GetTexture(sheet), sheet, (int)total, 0 });
+        total += count;
+    }
+
+    return commands;
 }
 
 inline size_t get_line(const std::string_view& string, int start)
@@ -272,34 +226,36 @@ int Font::GetWidth(std::string_view text)
 
 int Font::GetWidth(uint32_t glyph)
 {
-    auto found = this->glyphWidths.find(glyph);
-
-    if (found != this->glyphWidths.end())
-        return found->second;
+    return this->GetSpacing(this->FindGlyph(glyph));
+}
 
-    GlyphData* glyphData     = this->rasterizers[0]->GetGlyphData(glyph);
-    this->glyphWidths[glyph] = glyphData->GetAdvance();
+static inline Color clampColor(Color color)
+{
+    color.r = std::min(std::max(color.r, 0.0f), 1.0f);
+    color.g = std::min(std::max(color.g, 0.0f), 1.0f);
+    color.b = std::min(std::max(color.b, 0.0f), 1.0f);
+    color.a = std::min(std::max(color.a, 0.0f), 1.0f);
 
-    return this->glyphWidths[glyph];
+    return color;
 }
 
-std::vector<Font::DrawCommand> Font::GenerateVertices(const ColoredCodepoints& text,
-                                                      const Color& constantColor,
-                                                      std::vector<vertex::Vertex>& vertices,
-                                                      float extraSpacing, Vector2 offset,
-                                                      TextInfo* info)
+/*
+** Writes the glyphs of codepoints [@start, @end) straight into @vertices,
+** already transformed, at the end of their sheet's range in @commands.
+*/
+template<typename V>
+void Font::GenerateVertices(const ColoredCodepoints& text, int start, int end,
+                            const Color& constantColor, const Affine2D& transform, V* vertices,
+                            std::vector<DrawCommand>& commands, float extraSpacing,
+                            Vector2 offset, TextInfo* info)
 {
     float dx = offset.x;
     float dy = offset.y;
 
     float heightOffset = -this->GetBaseline();
+    float bearingY     = this->GetAscent();
 
     int maxWidth = 0;
-    std::vector<DrawCommand> commands {};
-
-    /* reserve max possible vertex size */
-    size_t startSize = vertices.size();
-    vertices.reserve(startSize + text.codepoints.size() * 6);
 
     uint32_t previousGlyph = 0;
     Color currentColor     = constantColor;
@@ -307,24 +263,18 @@ std::vector<Font::DrawCommand> Font::GenerateVertices(const ColoredCodepoints& t
     int colorIndex        = 0;
     const auto colorCount = (int)text.colors.size();
 
-    for (int index = 0; index < (int)text.codepoints.size(); index++)
+    /* pick up the color that was set before this range */
+    while (colorIndex < colorCount && text.colors[colorIndex].index <= start)
+        currentColor = clampColor(text.colors[colorIndex++].color);
+
+    for (int index = start; index < end; index++)
     {
         /* current glyph to work on */
         const auto glyph = text.codepoints[index];
 
         /* gamma correct the glyph's color */
-        if (colorIndex < colorCount && text.colors[colorIndex].index == index)
-        {
-            auto glyphColor = text.colors[colorIndex].color;
-
-            glyphColor.r = std::min(std::max(glyphColor.r, 0.0f), 1.0f);
-            glyphColor.g = std::min(std::max(glyphColor.g, 0.0f), 1.0f);
-            glyphColor.b = std::min(std::max(glyphColor.b, 0.0f), 1.0f);
-            glyphColor.a = std::min(std::max(glyphColor.a, 0.0f), 1.0f);
-
-            currentColor = glyphColor;
-            colorIndex++;
-        }
+        while (colorIndex < colorCount && text.colors[colorIndex].index <= index)
+            currentColor = clampColor(text.colors[colorIndex++].color);
 
         if (glyph == Font::NEWLINE_GLYPH)
         {
@@ -342,35 +292,57 @@ std::vector<Font::DrawCommand> Font::GenerateVertices(const ColoredCodepoints& t
         if (glyph == Font::CARRIAGE_GLYPH)
             continue;
 
-        const auto& glyphData = this->FindGlyph(glyph);
+        const auto& glyphData = this->FindGlyph(glyph, true);
         dx += this->GetKerning(previousGlyph, glyph);
 
         if (glyphData.texture != nullptr)
         {
+            auto& command = commands[this->sheetCounts[glyphData.sheet]];
+            auto* out     = vertices + command.start + command.count;
+
+            /* the shared table is in font units, scale the quad to this size */
+            const float x = dx + (int)(glyphData.bearingX * this->scale);
+            const float y = dy + bearingY + heightOffset;
+
+            const float width = (int)(glyphData.width * this->scale);
+
+            const auto [left, top, right, bottom] = glyphData.texcoords;
+
+            /* two triangles over the four corners, transformed once each */
+            Vector2 corners[0x04] = { Vector2(x, y), Vector2(x, y + this->height),
+                                      Vector2(x + width, y + this->height),
+                                      Vector2(x + width, y) };
+
+            transform.TransformXY(corners, corners, 0x04);
+
+            // clang-format off
+            const std::array<std::array<float, 0x02>, 0x04> texcoords =
+            {{
+                { left,  top    },
+                { left,  bottom },
+                { right, bottom },
+                { right, top    }
+            }};
+            // clang-format on
+
+            static constexpr int QUAD_CORNERS[0x06] = { 0, 1, 2, 2, 3, 0 };
+
             for (int j = 0; j < 0x06; j++)
             {
-                vertices.push_back(glyphData.vertices[j]);
-                vertices.back().position[0] += dx;
-                vertices.back().position[1] += dy + heightOffset;
-                vertices.back().color = currentColor.array();
-            }
+                const int corner = QUAD_CORNERS[j];
 
-            if (commands.empty() || commands.back().sheet != glyphData.sheet)
-            {
-                DrawCommand command {};
-                command.start   = (int)vertices.size() - 6;
-                command.count   = 0;
-                command.texture = glyphData.texture;
-                command.sheet   = glyphData.sheet;
+                out[j].position = { corners[corner].x, corners[corner].y, 0 };
+                out[j].texcoord = texcoords[corner];
 
-                commands.push_back(command);
+                if constexpr (std::is_same_v<V, vertex::Vertex>)
+                    out[j].color = currentColor.array();
             }
 
-            commands.back().count += 6;
+            command.count += 6;
         }
 
         /* advance the x position */
-        dx += glyphData.spacing;
+        dx += this->GetSpacing(glyphData);
 
         if (glyph == Font::SPACE_GLYPH && extraSpacing != 0.0f)
             dx = std::floor(dx + extraSpacing);
@@ -378,8 +350,6 @@ std::vector<Font::DrawCommand> Font::GenerateVertices(const ColoredCodepoints& t
         previousGlyph = glyph;
     }
 
-    // std::sort(commands.begin(), commands.end(), drawSort);
-
     if (dx > maxWidth)
         maxWidth = (int)dx;
 
@@ -390,8 +360,6 @@ std::vector<Font::DrawCommand> Font::GenerateVertices(const ColoredCodepoints& t
         const auto height = this->GetHeight() * this->GetLineHeight() + 0.5f;
         info->height      = (int)dy + (dx > 0.0f ? std::floor(height) : 0) - offset.y;
     }
-
-    return commands;
 }
 
 void Font::GetWrap(const std::vector<ColoredString>& text, float wraplimit,
@@ -421,8 +389,7 @@ void Font::GetWrap(const std::vector<ColoredString>& text, float wraplimit,
     }
 }
 
-void Font::GetWrap(const ColoredCodepoints& codepoints, float wraplimit,
-                   std::vector<ColoredCodepoints>& lines, std::vector<int>* linewidths)
+int Font::GetWrapLine(const Codepoints& codepoints, int start, float wraplimit, WrapLine& line)
 {
     float width = 0.0f;
 
@@ -431,49 +398,24 @@ void Font::GetWrap(const ColoredCodepoints& codepoints, float wraplimit,
 
     uint32_t previous  = 0;
     int lastSpaceIndex = -1;
+    bool empty         = true;
 
-    Color currentColor(1.0f, 1.0f, 1.0f, 1.0f);
-    bool addCurrentColor  = false;
-    int currentColorIndex = -1;
-    int endColorIndex     = (int)codepoints.colors.size() - 1;
-
-    ColoredCodepoints wrappedLine {};
+    line.start = start;
 
-    int index = 0;
-    while (index < (int)codepoints.codepoints.size())
+    int index = start;
+    while (index < (int)codepoints.size())
     {
-        uint32_t current = codepoints.codepoints[index];
-
-        /* determine current color */
-        if (currentColorIndex < endColorIndex &&
-            codepoints.colors[currentColorIndex + 1].index == index)
-        {
-            currentColor = codepoints.colors[currentColorIndex + 1].color;
-            currentColorIndex++;
-            addCurrentColor = true;
-        }
+        uint32_t current = codepoints[index];
 
         /* split at newlines */
         if (current == Font::NEWLINE_GLYPH)
         {
-            lines.push_back(wrappedLine);
-
             /* ignore width of trailing spaces for individual lines */
-            if (linewidths)
-                linewidths->push_back(width - widthOfTrailingSpace);
-
-            /* keep previously set color */
-            addCurrentColor = true;
-            width = widthBeforeLastSpace = widthOfTrailingSpace = 0.0f;
-
-            previous       = 0;
-            lastSpaceIndex = -1;
-            wrappedLine.codepoints.clear();
-            wrappedLine.colors.clear();
+            line.count = index - start;
+            line.width = width - widthOfTrailingSpace;
+            line.last  = index;
 
-            index++;
-
-            continue;
+            return index + 1;
         }
 
         if (current == Font::CARRIAGE_GLYPH)
@@ -484,60 +426,37 @@ void Font::GetWrap(const ColoredCodepoints& codepoints, float wraplimit,
 
         const auto& glyph = this->FindGlyph(current);
 
-        float charWidth = glyph.spacing + this->GetKerning(previous, current);
+        float charWidth = this->GetSpacing(glyph) + this->GetKerning(previous, current);
         float newWidth  = width + charWidth;
 
         /* wrap once we hit the line limit, except on newlines */
         if (current != Font::SPACE_GLYPH && newWidth > wraplimit)
         {
             /* skip the first character in the line if it exceeds the limit */
-            if (wrappedLine.codepoints.empty())
-                index++;
-            else if (lastSpaceIndex != -1)
+            if (empty)
             {
-                /* 'rewind' to last seen space, if the line contains one */
-                while (!wrappedLine.codepoints.empty() &&
-                       wrappedLine.codepoints.back() != Font::SPACE_GLYPH)
-                {
-                    wrappedLine.codepoints.pop_back();
-                }
-
-                while (!wrappedLine.colors.empty() &&
-                       wrappedLine.colors.back().index >= (int)wrappedLine.codepoints.size())
-                {
-                    wrappedLine.colors.pop_back();
-                }
-
-                /* 'rewind' to the last color */
-                for (int colorIndex = currentColorIndex; colorIndex >= 0; colorIndex--)
-                {
-                    if (codepoints.colors[colorIndex].index <= lastSpaceIndex)
-                    {
-                        currentColor      = codepoints.colors[colorIndex].color;
-                        currentColorIndex = colorIndex;
-                        break;
-                    }
-                }
-
-                width = widthBeforeLastSpace;
-                index = lastSpaceIndex;
-                index++;
-            }
+                line.count = index - start;
+                line.width = width;
+                line.last  = index;
 
-            lines.push_back(wrappedLine);
+                return index + 1;
+            }
 
-            if (linewidths)
-                linewidths->push_back(width);
+            /* 'rewind' to last seen space, if the line contains one */
+            if (lastSpaceIndex != -1)
+            {
+                line.count = lastSpaceIndex + 1 - start;
+                line.width = widthBeforeLastSpace;
+                line.last  = index;
 
-            addCurrentColor = true;
-            previous        = 0;
-            width = widthBeforeLastSpace = widthOfTrailingSpace = 0.0f;
+                return lastSpaceIndex + 1;
+            }
 
-            wrappedLine.codepoints.clear();
-            wrappedLine.colors.clear();
-            lastSpaceIndex = -1;
+            line.count = index - start;
+            line.width = width;
+            line.last  = index;
 
-            continue;
+            return index;
         }
 
         if (previous != Font::SPACE_GLYPH && current == Font::SPACE_GLYPH)
@@ -545,54 +464,109 @@ void Font::GetWrap(const ColoredCodepoints& codepoints, float wraplimit,
 
         width    = newWidth;
         previous = current;
-
-        if (addCurrentColor)
-        {
-            wrappedLine.colors.push_back({ currentColor, (int)wrappedLine.codepoints.size() });
-            addCurrentColor = false;
-        }
-
-        wrappedLine.codepoints.push_back(current);
+        empty    = false;
 
         if (current == Font::SPACE_GLYPH)
         {
             lastSpaceIndex       = index;
             widthOfTrailingSpace = charWidth;
         }
-        else if (current != Font::NEWLINE_GLYPH)
+        else
             widthOfTrailingSpace = 0.0f;
 
         index++;
     }
 
-    lines.push_back(wrappedLine);
+    line.count = index - start;
+    line.width = width - widthOfTrailingSpace;
+    line.last  = index;
 
-    if (linewidths)
-        linewidths->push_back(width - widthOfTrailingSpace);
+    return -1;
 }
 
-std::vector<Font::DrawCommand> Font::GenerateVerticesFormatted(
-    const ColoredCodepoints& text, const Color& constantColor, float wrap, AlignMode align,
-    std::vector<vertex::Vertex>& vertices, TextInfo* info)
+void Font::GetWrap(const Codepoints& codepoints, float wraplimit, std::vector<WrapLine>& lines)
 {
-    wrap = std::max(wrap, 0.0f);
+    WrapLine line {};
+    int next = 0;
+
+    do
+    {
+        next = this->GetWrapLine(codepoints, next, wraplimit, line);
+        lines.push_back(line);
+    } while (next >= 0);
+}
+
+void Font::GetWrap(const ColoredCodepoints& codepoints, float wraplimit,
+                   std::vector<ColoredCodepoints>& lines, std::vector<int>* linewidths)
+{
+    std::vector<WrapLine> spans {};
+    this->GetWrap(codepoints.codepoints, wraplimit, spans);
+
+    const auto& colors = codepoints.colors;
+    int colorIndex     = -1;
+
+    for (const auto& span : spans)
+    {
+        ColoredCodepoints wrappedLine {};
+        wrappedLine.codepoints.reserve(span.count);
+
+        /* carry over the color active at the start of the line */
+        while (colorIndex + 1 < (int)colors.size() && colors[colorIndex + 1].index <= span.start)
+            colorIndex++;
+
+        if (colorIndex >= 0)
+            wrappedLine.colors.push_back({ colors[colorIndex].color, 0 });
+
+        for (int index = span.start; index < span.start + span.count; index++)
+        {
+            const auto position = (int)wrappedLine.codepoints.size();
+
+            while (colorIndex + 1 < (int)colors.size() && colors[colorIndex + 1].index <= index)
+            {
+                colorIndex++;
+
+                /* only the last color set before a glyph applies to it */
+                if (!wrappedLine.colors.empty() && wrappedLine.colors.back().index == position)
+                    wrappedLine.colors.back().color = colors[colorIndex].color;
+                else
+                    wrappedLine.colors.push_back({ colors[colorIndex].color, position });
+            }
+
+            if (codepoints.codepoints[index] != Font::CARRIAGE_GLYPH)
+                wrappedLine.codepoints.push_back(codepoints.codepoints[index]);
+        }
 
-    std::vector<DrawCommand> commands;
-    vertices.reserve(text.codepoints.size() * 4);
+        /* a color set after the last glyph has nothing to apply to */
+        if (!wrappedLine.colors.empty() &&
+            wrappedLine.colors.back().index >= (int)wrappedLine.codepoints.size())
+        {
+            wrappedLine.colors.pop_back();
+        }
 
-    std::vector<int> widths;
-    std::vector<ColoredCodepoints> lines;
+        lines.push_back(std::move(wrappedLine));
 
-    this->GetWrap(text, wrap, lines, &widths);
+        if (linewidths)
+            linewidths->push_back(span.width);
+    }
+}
+
+template<typename V>
+void Font::GenerateVerticesFormatted(const ColoredCodepoints& text, const Color& constantColor,
+                                     float wrap, AlignMode align, const Affine2D& transform,
+                                     V* vertices, std::vector<DrawCommand>& commands,
+                                     TextInfo* info)
+{
+    wrap = std::max(wrap, 0.0f);
+
+    std::vector<WrapLine> lines {};
+    this->GetWrap(text.codepoints, wrap, lines);
 
     float y        = 0.0f;
     float maxWidth = 0.0f;
 
-    for (int index = 0; index < (int)lines.size(); index++)
+    for (const auto& line : lines)
     {
-        const auto& line = lines[index];
-
-        float width = (float)widths[index];
+        float width = (float)line.width;
 
         Vector2 offset(0.0f, floorf(y));
         float extraSpacing = 0.0f;
@@ -613,7 +587,8 @@ std::vector<Font::DrawCommand> Font::GenerateVerticesFormatted(
             }
             case ALIGN_JUSTIFY:
             {
-                float spaces = std::count(line.codepoints.begin(), line.codepoints.end(), ' ');
+                const auto first = text.codepoints.begin() + line.start;
+                float spaces     = std::count(first, first + line.count, ' ');
 
                 if (width < wrap && spaces >= 1)
                     extraSpacing = (wrap - width) / spaces;
@@ -627,32 +602,9 @@ std::vector<Font::DrawCommand> Font::GenerateVerticesFormatted(
                 break;
         }
 
-        std::vector<DrawCommand> newCommands =
-            this->GenerateVertices(line, constantColor, vertices, extraSpacing, offset);
+        this->GenerateVertices(text, line.start, line.start + line.count, constantColor, transform,
+                               vertices, commands, extraSpacing, offset);
 
-        if (!newCommands.empty())
-        {
-            auto first = newCommands.begin();
-
-            /*
-            ** if the first draw command has the same texture
-            ** as the last in the existing list and vertices
-            ** are in-order, we can combine them
-            */
-            if (!commands.empty())
-            {
-                auto previous = commands.back();
-
-                size_t total = (previous.start + previous.count);
-                if (previous.texture == first->texture && (int)total == first->start)
-                {
-                    commands.back().count += first->count;
-                    ++first;
-                }
-            }
-
-            commands.insert(commands.end(), first, newCommands.end());
-        }
         y += this->GetHeight() * this->GetLineHeight();
     }
 
@@ -661,20 +613,70 @@ std::vector<Font::DrawCommand> Font::GenerateVerticesFormatted(
         info->width  = (int)maxWidth;
         info->height = (int)y;
     }
+}
 
-    return commands;
+std::optional<Color> Font::GetFixedColor(const ColoredCodepoints& text, const Color& color)
+{
+    if (text.colors.empty())
+        return color;
+
+    /* GenerateVertices uses the first color from the first glyph on */
+    if (text.colors.size() == 1 && text.colors[0].index == 0)
+        return clampColor(text.colors[0].color);
+
+    return std::nullopt;
 }
 
-void Font::Print(Graphics& graphics, const ColoredStrings& text, const Matrix4& transform,
+template<typename Generator>
+bool Font::GenerateInto(size_t count, bool fixedColor, int& first, Generator&& generate)
+{
+    if (count == 0)
+        return false;
+
+    auto& renderer = Renderer::Instance();
+
+    void* vertices = nullptr;
+
+    if (fixedColor)
+        vertices = renderer.GetFixedColorVertices(count, first);
+    else
+        vertices = renderer.GetVertices(count, first);
+
+    if (vertices == nullptr)
+    {
+        LOG("Frame vertex buffer is full, dropping %zu text vertices", count);
+        return false;
+    }
+
+    if (fixedColor)
+        generate((vertex::FixedColorVertex*)vertices);
+    else
+        generate((vertex::Vertex*)vertices);
+
+    return true;
+}
+
+void Font::Print(Graphics& graphics, const ColoredStrings& text, const Matrix4& matrix,
                  const Color& color)
 {
     ColoredCodepoints codepoints {};
     Font::GetCodepointsFromString(text, codepoints);
 
-    std::vector<vertex::Vertex> vertices {};
-    auto commands = this->GenerateVertices(codepoints, color, vertices);
+    size_t total  = 0;
+    auto commands = this->ReserveSheets(codepoints.codepoints, total);
+
+    const Affine2D transform = graphics.GetTransform() * Affine2D(matrix);
+    const auto fixedColor = Font::GetFixedColor(codepoints, color);
+
+    const auto generate = [&](auto* vertices) {
+        this->GenerateVertices(codepoints, 0, (int)codepoints.codepoints.size(), color, transform,
+                               vertices, commands);
+    };
 
-    this->Render(graphics, transform, commands, vertices);
+    int first = 0;
+
+    if (this->GenerateInto(total, fixedColor.has_value(), first, generate))
+        this->Render(commands, first, fixedColor);
 }
 
 void Font::Printf(Graphics& graphics, const ColoredStrings& text, float wrap, AlignMode alignment,
@@ -683,34 +685,43 @@ void Font::Printf(Graphics& graphics, const ColoredStrings& text, float wrap, Al
     ColoredCodepoints codepoints {};
     Font::GetCodepointsFromString(text, codepoints);
 
-    std::vector<vertex::Vertex> vertices {};
-    std::vector<DrawCommand> commands =
-        this->GenerateVerticesFormatted(codepoints, color, wrap, alignment, vertices);
+    size_t total  = 0;
+    auto commands = this->ReserveSheets(codepoints.codepoints, total);
+
+    const Affine2D transform = graphics.GetTransform() * Affine2D(matrix);
+    const auto fixedColor = Font::GetFixedColor(codepoints, color);
 
-    this->Render(graphics, matrix, commands, vertices);
+    const auto generate = [&](auto* vertices) {
+        this->GenerateVerticesFormatted(codepoints, color, wrap, alignment, transform, vertices,
+                                        commands);
+    };
+
+    int first = 0;
+
+    if (this->GenerateInto(total, fixedColor.has_value(), first, generate))
+        this->Render(commands, first, fixedColor);
 }
 
-void Font::Render(Graphics& graphics, const Matrix4& matrix,
-                  const std::vector<DrawCommand>& commands,
-                  const std::vector<vertex::Vertex>& vertices)
+void Font::Render(const std::vector<DrawCommand>& commands, int first,
+                  const std::optional<Color>& fixedColor)
 {
-    if (vertices.empty() || commands.empty())
-        return;
+    /* glyphs repacked while laying out have to reach the GPU first */
+    this->table->Flush();
 
-    const auto& transform = graphics.GetTransform();
-    bool is2D             = transform.IsAffine2DTransform();
+    auto texEnv = love::DrawCommand::TEXENV_MODE_TEXT;
 
-    Matrix4 translated(transform, matrix);
+    if (this->table->IsDistanceField())
+        texEnv = love::DrawCommand::TEXENV_MODE_DISTANCE_FIELD;
 
     for (const auto& command : commands)
     {
-        love::DrawCommand drawCommand(command.count, vertex::PRIMITIVE_TRIANGLES);
-        drawCommand.handles = { command.texture };
+        if (command.count == 0)
+            continue;
 
-        translated.TransformXY(drawCommand.Positions().get(), &vertices[command.start],
-                               command.count);
+        love::DrawCommand drawCommand(command.count, first + command.start, texEnv);
+        drawCommand.handles    = { command.texture };
+        drawCommand.fixedColor = fixedColor;
 
-        drawCommand.FillVertices(&vertices[command.start]);
         Renderer::Instance().Render(drawCommand);
     }
-}
\ No newline at end of file
+}
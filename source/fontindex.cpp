@@ -0,0 +1,169 @@
+#include "fontindex.hpp"
+#include "exception.hpp"
+
+#include <algorithm>
+
+using namespace love;
+
+FontIndex::FontIndex() : font(nullptr), alterCharIndex(0), pages {}, entries {}, widths {}
+{}
+
+void FontIndex::Clear()
+{
+    this->font = nullptr;
+    this->pages.fill(0);
+
+    this->entries.clear();
+    this->entries.shrink_to_fit();
+
+    this->widths.clear();
+    this->widths.shrink_to_fit();
+}
+
+void FontIndex::SetGlyphIndex(uint32_t codepoint, uint16_t glyphIndex)
+{
+    if (codepoint > MAX_CODEPOINT || glyphIndex == UNMAPPED)
+        return;
+
+    auto& page = this->pages[codepoint >> PAGE_SHIFT];
+
+    if (page == 0)
+    {
+        page = (uint32_t)this->entries.size();
+        this->entries.resize(this->entries.size() + PAGE_SIZE, UNMAPPED);
+    }
+
+    /* earlier CMAP sections take priority, same as fontGlyphIndexFromCodePoint */
+    auto& entry = this->entries[page + (codepoint & PAGE_MASK)];
+
+    if (entry == UNMAPPED)
+        entry = glyphIndex;
+}
+
+void FontIndex::Build(CFNT_s* font)
+{
+    this->Clear();
+
+    if (font == nullptr)
+        return;
+
+    const auto* info     = fontGetInfo(font);
+    const auto* sheets   = info->tglp;
+    this->alterCharIndex = info->alterCharIndex;
+
+    try
+    {
+        this->entries.assign(PAGE_SIZE, UNMAPPED);
+
+        for (const CMAP_s* cmap = info->cmap; cmap != nullptr; cmap = cmap->next)
+        {
+            switch (cmap->mappingMethod)
+            {
+                case CMAP_TYPE_DIRECT:
+                {
+                    for (uint32_t code = cmap->codeBegin; code <= cmap->codeEnd; code++)
+                        this->SetGlyphIndex(code, cmap->indexOffset + (code - cmap->codeBegin));
+
+                    break;
+                }
+                case CMAP_TYPE_TABLE:
+                {
+                    for (uint32_t code = cmap->codeBegin; code <= cmap->codeEnd; code++)
+                        this->SetGlyphIndex(code, cmap->indexTable[code - cmap->codeBegin]);
+
+                    break;
+                }
+                case CMAP_TYPE_SCAN:
+                {
+                    for (uint16_t index = 0; index < cmap->nScanEntries; index++)
+                    {
+                        const auto& entry = cmap->scanEntries[index];
+
+                        if (entry.code >= cmap->codeBegin && entry.code <= cmap->codeEnd)
+                            this->SetGlyphIndex(entry.code, entry.glyphIndex);
+                    }
+
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        /* anything left unmapped resolves to the replacement character */
+        std::replace(this->entries.begin(), this->entries.end(), UNMAPPED, this->alterCharIndex);
+
+        const size_t glyphCount = sheets->nSheets * sheets->nRows * sheets->nLines;
+        this->widths.assign(glyphCount, info->defaultWidth);
+
+        std::vector<const CWDH_s*> sections {};
+        for (const CWDH_s* cwdh = info->cwdh; cwdh != nullptr; cwdh = cwdh->next)
+            sections.push_back(cwdh);
+
+        /* apply back to front so the first matching section wins */
+        for (auto it = sections.rbegin(); it != sections.rend(); ++it)
+        {
+            const auto* cwdh = *it;
+            const auto end   = std::min<size_t>(cwdh->endIndex + 1, glyphCount);
+
+            for (size_t index = cwdh->startIndex; index < end; index++)
+                this->widths[index] = cwdh->widths[index - cwdh->startIndex];
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        this->Clear();
+        throw love::Exception("Not enough memory.");
+    }
+
+    this->font = font;
+}
+
+const charWidthInfo_s& FontIndex::GetWidthInfo(int glyphIndex) const
+{
+    if (glyphIndex < 0 || glyphIndex >= (int)this->widths.size())
+        return fontGetInfo(this->font)->defaultWidth;
+
+    return this->widths[glyphIndex];
+}
+
+void FontIndex::CalcGlyphPos(fontGlyphPos_s* out, int glyphIndex, float scaleX,
+                             float scaleY) const
+{
+    const auto* sheets = fontGetGlyphInfo(this->font);
+    const auto& width  = this->GetWidthInfo(glyphIndex);
+
+    const int perSheet = sheets->nRows * sheets->nLines;
+    const int inSheet  = glyphIndex % perSheet;
+
+    out->sheetIndex = glyphIndex / perSheet;
+    out->xOffset    = scaleX * width.left;
+    out->xAdvance   = scaleX * width.charWidth;
+    out->width      = scaleX * width.glyphWidth;
+
+    const int line = inSheet / sheets->nRows;
+    const int row  = inSheet % sheets->nRows;
+
+    // clang-format off
+    const float tx = (float)(row * (sheets->cellWidth + 1) + 1) / sheets->sheetWidth;
+    const float ty = 1.0f - (float)((line + 1) * (sheets->cellHeight + 1) + 1) / sheets->sheetHeight;
+    const float tw = (float)width.glyphWidth / sheets->sheetWidth;
+    const float th = (float)sheets->cellHeight / sheets->sheetHeight;
+    // clang-format on
+
+    out->texcoord.left   = tx;
+    out->texcoord.top    = ty + th;
+    out->texcoord.right  = tx + tw;
+    out->texcoord.bottom = ty;
+
+    out->vtxcoord.left   = out->xOffset;
+    out->vtxcoord.top    = 0.0f;
+    out->vtxcoord.right  = out->xOffset + out->width;
+    out->vtxcoord.bottom = scaleY * sheets->cellHeight;
+}
+
+size_t FontIndex::GetMemoryUsage() const
+{
+    return sizeof(this->pages) + this->entries.size() * sizeof(uint16_t) +
+           this->widths.size() * sizeof(charWidthInfo_s);
+}
@@ -2,6 +2,7 @@
 #include "exception.hpp"
 
 #include <array>
+#include <filesystem>
 #include <memory>
 
 using namespace love;
@@ -13,15 +14,91 @@ static constexpr std::array<const char*, 0x04> fontPaths = {
     "font:/cbf_zh-Hant-TW.bcfnt.lz",
 };
 
+/* decompressed fonts are cached as BCFNT files, before their pointers are fixed */
+static constexpr uint32_t CFNT_MAGIC = 0x544E4643;
+
+static std::string getCachePath(const char* path)
+{
+    if (FontModule::cacheDirectory.empty())
+        return std::string {};
+
+    std::string_view name(path);
+
+    if (auto slash = name.find_last_of(":/"); slash != std::string_view::npos)
+        name.remove_prefix(slash + 1);
+
+    if (name.ends_with(".lz"))
+        name.remove_suffix(3);
+
+    return FontModule::cacheDirectory + "/" + std::string(name);
+}
+
+static CFNT_s* loadFromCache(const std::string& path)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+
+    if (!file)
+        return nullptr;
+
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::rewind(file);
+
+    CFNT_s* font = nullptr;
+
+    if (size > (long)sizeof(CFNT_s))
+        font = (CFNT_s*)linearAlloc(size);
+
+    if (font != nullptr)
+    {
+        size_t read = std::fread((uint8_t*)font, 1, size, file);
+
+        /* anything truncated or stale gets decompressed again */
+        if (read != (size_t)size || font->signature != CFNT_MAGIC || font->fileSize != read)
+        {
+            linearFree(font);
+            font = nullptr;
+        }
+    }
+
+    std::fclose(file);
+
+    return font;
+}
+
+static void saveToCache(const std::string& path, const CFNT_s* font, size_t size)
+{
+    std::error_code error;
+    std::filesystem::create_directories(FontModule::cacheDirectory, error);
+
+    /* write to a temporary file first, a partial cache is never picked up */
+    const std::string temporary = path + ".tmp";
+    std::FILE* file             = std::fopen(temporary.c_str(), "wb");
+
+    if (!file)
+        return;
+
+    bool written = std::fwrite((const uint8_t*)font, 1, size, file) == size;
+    written      = (std::fclose(file) == 0) && written;
+
+    if (!written || std::rename(temporary.c_str(), path.c_str()) != 0)
+        std::remove(temporary.c_str());
+}
+
 static CFNT_s* loadFromArchive(uint64_t title, const char* path)
 {
-    std::unique_ptr<uint8_t[]> fontData;
-    uint32_t size = 0;
+    const std::string cachePath = getCachePath(path);
 
-    Result result = 0;
-    CFNT_s* font  = nullptr;
+    if (!cachePath.empty())
+    {
+        if (CFNT_s* font = loadFromCache(cachePath); font != nullptr)
+        {
+            fontFixPointers(font);
+            return font;
+        }
+    }
 
-    result = romfsMountFromTitle(title, MEDIATYPE_NAND, "font");
+    Result result = romfsMountFromTitle(title, MEDIATYPE_NAND, "font");
 
     if (R_FAILED(result))
         return nullptr;
@@ -30,37 +107,52 @@ static CFNT_s* loadFromArchive(uint64_t title, const char* path)
 
     if (!file)
     {
-        std::fclose(file);
+        romfsUnmount("font");
         return nullptr;
     }
 
     std::fseek(file, 0, SEEK_END);
-    size = (uint32_t)std::ftell(file);
+    size_t size = (size_t)std::ftell(file);
     std::rewind(file);
 
-    try
+    decompressType type = DECOMPRESS_DUMMY;
+    size_t fontSize     = 0;
+
+    /* the archive is streamed through libctru's chunked reader, never held whole */
+    ssize_t header = decompressHeader(&type, &fontSize, decompressCallback_Stdio, file, 0);
+
+    if (header < 0 || type != DECOMPRESS_LZ11)
     {
-        fontData = std::make_unique<uint8_t[]>(size);
+        std::fclose(file);
+        romfsUnmount("font");
+
+        throw love::Exception("Failed to decompress '%s'", path);
     }
-    catch (std::bad_alloc&)
+
+    CFNT_s* font = (CFNT_s*)linearAlloc(fontSize);
+
+    if (font == nullptr)
     {
+        std::fclose(file);
+        romfsUnmount("font");
+
         throw love::Exception("Not enough memory.");
     }
 
-    std::fread(fontData.get(), 1, size, file);
-    std::fclose(file);
+    bool success = decompress_LZ11(font, fontSize, decompressCallback_Stdio, file, size - header);
 
+    std::fclose(file);
     romfsUnmount("font");
 
-    uint32_t fontSize = *(uint32_t*)fontData.get() >> 0x08;
-    font              = (CFNT_s*)linearAlloc(fontSize);
-
-    if (font && !decompress_LZ11(font, fontSize, nullptr, fontData.get() + 4, size - 4))
+    if (!success)
     {
         linearFree(font);
         throw love::Exception("Failed to decompress '%s'", path);
     }
 
+    if (!cachePath.empty())
+        saveToCache(cachePath, font, fontSize);
+
     fontFixPointers(font);
 
     return font;
@@ -82,20 +174,51 @@ static size_t getFontIndex(CFG_Region region)
     }
 }
 
-CFNT_s* FontModule::LoadSystemFont(CFG_Region region)
+/*
+** Builds @index for a font in linear memory. The caller never receives the
+** font if this throws, so the allocation is released before rethrowing.
+*/
+static void buildIndex(CFNT_s* font, FontIndex* index)
+{
+    if (index == nullptr)
+        return;
+
+    try
+    {
+        index->Build(font);
+    }
+    catch (...)
+    {
+        linearFree(font);
+        throw;
+    }
+}
+
+CFNT_s* FontModule::LoadSystemFont(CFG_Region region, FontIndex* fontIndex)
 {
     size_t index         = getFontIndex(region);
     uint8_t systemRegion = 0;
 
+    CFNT_s* font  = nullptr;
     Result result = CFGU_SecureInfoGetRegion(&systemRegion);
 
     if (R_FAILED(result) || index == getFontIndex((CFG_Region)systemRegion))
-        return fontGetSystemFont();
+    {
+        font = fontGetSystemFont();
+
+        if (fontIndex != nullptr)
+            fontIndex->Build(font);
+    }
+    else
+    {
+        font = loadFromArchive(FontModule::FONT_ARCHIVE | (index << 8), fontPaths[index]);
+        buildIndex(font, fontIndex);
+    }
 
-    return loadFromArchive(FontModule::FONT_ARCHIVE | (index << 8), fontPaths[index]);
+    return font;
 }
 
-CFNT_s* FontModule::LoadFromFile(const void* data, size_t size)
+CFNT_s* FontModule::LoadFromFile(const void* data, size_t size, FontIndex* index)
 {
     CFNT_s* font = (CFNT_s*)linearAlloc(size);
 
@@ -105,15 +228,72 @@ CFNT_s* FontModule::LoadFromFile(const void* data, size_t size)
         throw love::Exception("Failed to allocate font.");
 
     fontFixPointers(font);
+    buildIndex(font, index);
+
+    return font;
+}
+
+CFNT_s* FontModule::LoadFromPath(const char* path, FontIndex* index)
+{
+    std::FILE* file = std::fopen(path, "rb");
+
+    if (!file)
+        throw love::Exception("File '%s' does not exist.", path);
+
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::rewind(file);
+
+    if (size <= 0)
+    {
+        std::fclose(file);
+        throw love::Exception("Failed to read font '%s'.", path);
+    }
+
+    CFNT_s* font = (CFNT_s*)linearAlloc(size);
+
+    if (font == nullptr)
+    {
+        std::fclose(file);
+        throw love::Exception("Failed to allocate font.");
+    }
+
+    size_t read = std::fread((uint8_t*)font, 1, size, file);
+    std::fclose(file);
+
+    if (read != (size_t)size)
+    {
+        linearFree(font);
+        throw love::Exception("Failed to read font '%s'.", path);
+    }
+
+    fontFixPointers(font);
+    buildIndex(font, index);
 
     return font;
 }
 
+void FontModule::FreeFont(CFNT_s* font)
+{
+    if (font != nullptr)
+        linearFree(font);
+}
+
 Rasterizer* FontModule::NewRasterizer(const void* data, size_t dataSize, float size)
 {
     return new Rasterizer(data, dataSize, size);
 }
 
+Rasterizer* FontModule::NewRasterizer(const char* path, float size)
+{
+    return new Rasterizer(path, size);
+}
+
+Rasterizer* FontModule::NewRasterizer(Rasterizer* base, float size)
+{
+    return new Rasterizer(base, size);
+}
+
 Rasterizer* FontModule::NewRasterizer(float size, CFG_Region region)
 {
     return new Rasterizer(region, size);
@@ -0,0 +1,55 @@
+#include "frameallocator.hpp"
+
+#include "exception.hpp"
+#include "logfile.hpp"
+
+#include <algorithm>
+
+using namespace love;
+
+FrameAllocator::FrameAllocator() :
+    arena(std::make_unique<uint8_t[]>(CAPACITY)),
+    used(0),
+    overflow {},
+    overflowSize(0),
+    highWater(0)
+{}
+
+void* FrameAllocator::AllocateBytes(size_t size, size_t alignment)
+{
+    const size_t start = (this->used + alignment - 1) & ~(alignment - 1);
+
+    if (start + size <= CAPACITY)
+    {
+        this->used      = start + size;
+        this->highWater = std::max(this->highWater, this->GetUsed());
+
+        return this->arena.get() + start;
+    }
+
+    if (this->overflow.empty())
+        LOG("Frame allocator is full (%zu bytes), using the heap", (size_t)CAPACITY);
+
+    try
+    {
+        /* operator new[] is aligned for any fundamental type */
+        this->overflow.push_back(std::make_unique<uint8_t[]>(size));
+    }
+    catch (std::bad_alloc&)
+    {
+        throw love::Exception("Out of memory.");
+    }
+
+    this->overflowSize += size;
+    this->highWater = std::max(this->highWater, this->GetUsed());
+
+    return this->overflow.back().get();
+}
+
+void FrameAllocator::Reset()
+{
+    this->used         = 0;
+    this->overflowSize = 0;
+
+    this->overflow.clear();
+}
@@ -0,0 +1,535 @@
+#include "glyphtable.hpp"
+
+#include "color.hpp"
+#include "renderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+using namespace love;
+
+static constexpr auto MIN_MAG =
+    GPU_TEXTURE_MAG_FILTER(GPU_LINEAR) | GPU_TEXTURE_MIN_FILTER(GPU_LINEAR);
+
+static constexpr auto WRAP =
+    GPU_TEXTURE_WRAP_S(GPU_CLAMP_TO_BORDER) | GPU_TEXTURE_WRAP_T(GPU_CLAMP_TO_BORDER);
+
+static int bitsPerPixel(GPU_TEXCOLOR format)
+{
+    switch (format)
+    {
+        case GPU_RGBA8:
+            return 32;
+        case GPU_RGB8:
+            return 24;
+        case GPU_RGBA5551:
+        case GPU_RGB565:
+        case GPU_RGBA4:
+        case GPU_LA8:
+        case GPU_HILO8:
+            return 16;
+        case GPU_L8:
+        case GPU_A8:
+        case GPU_LA4:
+            return 8;
+        case GPU_L4:
+        case GPU_A4:
+            return 4;
+        default: /* ETC1 is compressed in 4x4 blocks, not per pixel */
+            return 0;
+    }
+}
+
+StrongReference<GlyphTable> GlyphTable::Get(Rasterizer* rasterizer)
+{
+    const auto iterator = GlyphTable::tables.find(rasterizer->GetFont());
+
+    if (iterator != GlyphTable::tables.end())
+        return StrongReference<GlyphTable>(iterator->second);
+
+    return StrongReference<GlyphTable>(new GlyphTable(rasterizer), Acquire::NORETAIN);
+}
+
+GlyphTable::GlyphTable(Rasterizer* rasterizer) :
+    rasterizer(rasterizer),
+    face(rasterizer->GetFont()),
+    textures {},
+    glyphs {},
+    useSpacesAsTab(!rasterizer->HasGlyph(GlyphTable::TAB_GLYPH)),
+    distanceField(rasterizer->IsDistanceField()),
+    repacking(false),
+    dirty(false),
+    atlases {},
+    slots {},
+    slotWidth(0),
+    slotHeight(0),
+    slotColumns(0),
+    slotsPerAtlas(0)
+{
+    const auto* glyphInfo = fontGetGlyphInfo(this->face);
+
+    this->textures.reserve(glyphInfo->nSheets);
+
+    for (size_t index = 0; index < glyphInfo->nSheets; index++)
+    {
+        this->textures.push_back(C3D_Tex {});
+
+        C3D_Tex* texture  = &this->textures[index];
+        texture->data     = fontGetGlyphSheetTex(this->face, index);
+        texture->fmt      = (GPU_TEXCOLOR)glyphInfo->sheetFmt;
+        texture->size     = glyphInfo->sheetSize;
+        texture->width    = glyphInfo->sheetWidth;
+        texture->height   = glyphInfo->sheetHeight;
+        texture->param    = MIN_MAG | WRAP;
+        texture->border   = 0;
+        texture->lodParam = 0;
+    }
+
+    GlyphTable::tables[this->face] = this;
+}
+
+GlyphTable::~GlyphTable()
+{
+    this->ClearAtlases();
+    GlyphTable::tables.erase(this->face);
+}
+
+const GlyphTable::Glyph& GlyphTable::Add(uint32_t codepoint, bool draw)
+{
+    GlyphData::GlyphMetrics metrics {};
+    GlyphData::GlyphSheetInfo info {};
+
+    if (codepoint == GlyphTable::TAB_GLYPH && this->useSpacesAsTab)
+    {
+        this->rasterizer->GetGlyphMetrics(GlyphTable::SPACE_GLYPH, 1.0f, metrics, info);
+
+        metrics.width = 0;
+        metrics.advance *= GlyphTable::SPACES_PER_TAB;
+    }
+    else
+        this->rasterizer->GetGlyphMetrics(codepoint, 1.0f, metrics, info);
+
+    Glyph glyph {};
+
+    glyph.texture   = nullptr;
+    glyph.sheet     = info.index;
+    glyph.bearingX  = metrics.bearingX;
+    glyph.width     = metrics.width;
+    glyph.advance   = metrics.advance;
+    glyph.texcoords = { info.left, info.top, info.right, info.bottom };
+
+    if (metrics.width > 0 && metrics.height > 0)
+        glyph.texture = &this->textures[glyph.sheet];
+
+    auto& added = this->glyphs[codepoint] = glyph;
+
+    if (draw && this->repacking)
+        this->Touch(codepoint, added);
+
+    return added;
+}
+
+bool GlyphTable::SetRepacking(bool enable, int atlasCount)
+{
+    this->ClearAtlases();
+
+    if (!enable)
+        return true;
+
+    const auto* glyphInfo = fontGetGlyphInfo(this->face);
+    const auto format     = (GPU_TEXCOLOR)glyphInfo->sheetFmt;
+
+    if (bitsPerPixel(format) == 0 || atlasCount < 1)
+        return false;
+
+    /* keep a texel of empty gutter around every glyph for linear filtering */
+    this->slotWidth     = glyphInfo->cellWidth + 1;
+    this->slotHeight    = glyphInfo->cellHeight + 1;
+    this->slotColumns   = GlyphTable::ATLAS_SIZE / this->slotWidth;
+    this->slotsPerAtlas = this->slotColumns * (GlyphTable::ATLAS_SIZE / this->slotHeight);
+
+    this->atlases.reserve(atlasCount);
+
+    for (int index = 0; index < atlasCount; index++)
+    {
+        C3D_Tex atlas {};
+
+        if (!C3D_TexInit(&atlas, GlyphTable::ATLAS_SIZE, GlyphTable::ATLAS_SIZE, format))
+            break;
+
+        std::memset(atlas.data, 0, atlas.size);
+
+        atlas.param  = MIN_MAG | WRAP;
+        atlas.border = 0;
+
+        this->atlases.push_back(atlas);
+    }
+
+    if (this->atlases.empty())
+        return false;
+
+    this->slots.assign(this->atlases.size() * this->slotsPerAtlas, AtlasSlot {});
+
+    this->repacking = true;
+    this->dirty     = true;
+
+    return true;
+}
+
+void GlyphTable::ClearAtlases()
+{
+    /* everything goes back to being drawn from its sheet */
+    for (const auto& slot : this->slots)
+    {
+        if (slot.used)
+            this->glyphs[slot.codepoint] = slot.original;
+    }
+
+    for (auto& atlas : this->atlases)
+        C3D_TexDelete(&atlas);
+
+    this->atlases.clear();
+    this->slots.clear();
+
+    this->repacking = false;
+    this->dirty     = false;
+}
+
+void GlyphTable::Flush()
+{
+    if (!this->dirty)
+        return;
+
+    for (auto& atlas : this->atlases)
+        C3D_TexFlush(&atlas);
+
+    this->dirty = false;
+}
+
+void GlyphTable::Touch(uint32_t codepoint, Glyph& glyph)
+{
+    if (glyph.slot >= 0)
+    {
+        this->slots[glyph.slot].frame = Renderer::GetFrame();
+        return;
+    }
+
+    if (glyph.texture == nullptr)
+        return;
+
+    const int slot = this->FindSlot();
+
+    /* full with glyphs drawn this frame, keep drawing this one from its sheet */
+    if (slot < 0)
+        return;
+
+    auto& atlasSlot = this->slots[slot];
+
+    if (atlasSlot.used)
+        this->glyphs[atlasSlot.codepoint] = atlasSlot.original;
+
+    atlasSlot = { codepoint, glyph, Renderer::GetFrame(), true };
+    this->CopyToSlot(atlasSlot.original, slot, glyph);
+}
+
+int GlyphTable::FindSlot() const
+{
+    const uint32_t frame = Renderer::GetFrame();
+
+    int oldest         = -1;
+    uint32_t oldestAge = 0;
+
+    for (int index = 0; index < (int)this->slots.size(); index++)
+    {
+        const auto& slot = this->slots[index];
+
+        if (!slot.used)
+            return index;
+
+        /* glyphs drawn this frame may still be read by the GPU */
+        if (slot.frame == frame)
+            continue;
+
+        if (frame - slot.frame > oldestAge)
+        {
+            oldest    = index;
+            oldestAge = frame - slot.frame;
+        }
+    }
+
+    return oldest;
+}
+
+void GlyphTable::CopyToSlot(const Glyph& glyph, int slot, Glyph& out)
+{
+    const auto* glyphInfo = fontGetGlyphInfo(this->face);
+
+    const C3D_Tex& sheet = this->textures[glyph.sheet];
+    const int atlasIndex = slot / this->slotsPerAtlas;
+    C3D_Tex& atlas       = this->atlases[atlasIndex];
+
+    const int local = slot % this->slotsPerAtlas;
+    const int x     = (local % this->slotColumns) * this->slotWidth;
+    const int y     = (local / this->slotColumns) * this->slotHeight;
+
+    /* sheet texcoords have v pointing up, tiled rows start at the top */
+    const int sourceX = (int)std::lround(glyph.texcoords[0] * sheet.width);
+    const int sourceY = (int)std::lround((1.0f - glyph.texcoords[1]) * sheet.height);
+
+    const int width  = std::min<int>(glyphInfo->cellWidth, sheet.width - sourceX);
+    const int height = std::min<int>(glyphInfo->cellHeight, sheet.height - sourceY);
+
+    const int bits = bitsPerPixel(atlas.fmt);
+
+    const auto* source = (const uint8_t*)sheet.data;
+    auto* destination  = (uint8_t*)atlas.data;
+
+    for (int row = 0; row < height; row++)
+    {
+        for (int column = 0; column < width; column++)
+        {
+            const Vector2 from(sourceX + column, sourceY + row);
+            const Vector2 to(x + column, y + row);
+
+            const unsigned in  = Color::TileIndex(sheet.width, from);
+            const unsigned out = Color::TileIndex(atlas.width, to);
+
+            if (bits == 4)
+            {
+                const uint8_t texel = (source[in / 2] >> ((in & 1) * 4)) & 0x0F;
+                const int shift     = (out & 1) * 4;
+
+                destination[out / 2] = (destination[out / 2] & ~(0x0F << shift)) | (texel << shift);
+            }
+            else
+                std::memcpy(destination + out * (bits / 8), source + in * (bits / 8), bits / 8);
+        }
+    }
+
+    const float scaleX = (float)sheet.width / atlas.width;
+    const float scaleY = (float)sheet.height / atlas.height;
+
+    out.texture = &atlas;
+    out.sheet   = (int)this->textures.size() + atlasIndex;
+    out.slot    = slot;
+
+    const float left = (float)x / atlas.width;
+    const float top  = 1.0f - (float)y / atlas.height;
+
+    out.texcoords = { left, top, left + (glyph.texcoords[2] - glyph.texcoords[0]) * scaleX,
+                      top - (glyph.texcoords[1] - glyph.texcoords[3]) * scaleY };
+
+    this->dirty = true;
+}
+
+/*
+** Glyph cache layout: a header identifying the face it was built for, then
+** one record per glyph. Only the texture pointer is rebuilt on load.
+*/
+struct GlyphCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t faceSize;
+    uint32_t count;
+    uint64_t faceHash;
+};
+
+struct GlyphCacheRecord
+{
+    uint32_t codepoint;
+    int32_t sheet; //< -1 when the glyph has nothing to draw
+    int32_t bearingX;
+    int32_t width;
+    int32_t advance;
+    std::array<float, 0x04> texcoords;
+};
+
+static constexpr uint32_t GLYPH_CACHE_MAGIC   = 0x434C474C; //< "LGLC"
+static constexpr uint32_t GLYPH_CACHE_VERSION = 3;
+
+/* FNV-1a, continuing from @hash */
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+{
+    const auto* bytes = (const uint8_t*)data;
+
+    for (size_t index = 0; index < size; index++)
+        hash = (hash ^ bytes[index]) * 0x100000001B3;
+
+    return hash;
+}
+
+template<typename T>
+static uint64_t hashValue(uint64_t hash, T value)
+{
+    return hashBytes(hash, &value, sizeof(T));
+}
+
+/*
+** Identifies a face by everything a cache record is derived from: the cell
+** layout, the glyph widths and the codepoint mapping. Pointers are fixed up
+** on load, so only the values are hashed, never the raw headers.
+*/
+static uint64_t hashFace(CFNT_s* face)
+{
+    const FINF_s* info   = fontGetInfo(face);
+    const TGLP_s* sheets = info->tglp;
+
+    uint64_t hash = 0xCBF29CE484222325;
+
+    hash = hashValue(hash, info->fontType);
+    hash = hashValue(hash, info->alterCharIndex);
+    hash = hashBytes(hash, &info->defaultWidth, sizeof(charWidthInfo_s));
+
+    hash = hashValue(hash, sheets->cellWidth);
+    hash = hashValue(hash, sheets->cellHeight);
+    hash = hashValue(hash, sheets->baselinePos);
+    hash = hashValue(hash, sheets->sheetSize);
+    hash = hashValue(hash, sheets->nSheets);
+    hash = hashValue(hash, sheets->sheetFmt);
+    hash = hashValue(hash, sheets->nRows);
+    hash = hashValue(hash, sheets->nLines);
+    hash = hashValue(hash, sheets->sheetWidth);
+    hash = hashValue(hash, sheets->sheetHeight);
+
+    for (const CWDH_s* widths = info->cwdh; widths != nullptr; widths = widths->next)
+    {
+        hash = hashValue(hash, widths->startIndex);
+        hash = hashValue(hash, widths->endIndex);
+
+        const size_t count = widths->endIndex - widths->startIndex + 1;
+        hash               = hashBytes(hash, widths->widths, count * sizeof(charWidthInfo_s));
+    }
+
+    for (const CMAP_s* map = info->cmap; map != nullptr; map = map->next)
+    {
+        hash = hashValue(hash, map->codeBegin);
+        hash = hashValue(hash, map->codeEnd);
+        hash = hashValue(hash, map->mappingMethod);
+
+        switch (map->mappingMethod)
+        {
+            case CMAP_TYPE_DIRECT:
+                hash = hashValue(hash, map->indexOffset);
+                break;
+            case CMAP_TYPE_TABLE:
+            {
+                const size_t count = map->codeEnd - map->codeBegin + 1;
+                hash               = hashBytes(hash, map->indexTable, count * sizeof(uint16_t));
+                break;
+            }
+            case CMAP_TYPE_SCAN:
+                hash = hashValue(hash, map->nScanEntries);
+                hash = hashBytes(hash, map->scanEntries,
+                                 map->nScanEntries * sizeof(map->scanEntries[0]));
+                break;
+        }
+    }
+
+    return hash;
+}
+
+bool GlyphTable::Save(const char* path) const
+{
+    std::FILE* file = std::fopen(path, "wb");
+
+    if (!file)
+        return false;
+
+    GlyphCacheHeader header {};
+    header.magic    = GLYPH_CACHE_MAGIC;
+    header.version  = GLYPH_CACHE_VERSION;
+    header.faceSize = this->face->fileSize;
+    header.count    = (uint32_t)this->glyphs.size();
+    header.faceHash = hashFace(this->face);
+
+    std::vector<GlyphCacheRecord> records {};
+    records.reserve(this->glyphs.size());
+
+    for (const auto& [codepoint, entry] : this->glyphs)
+    {
+        /* repacked glyphs are saved as they are on their sheet */
+        const auto& glyph = entry.slot >= 0 ? this->slots[entry.slot].original : entry;
+
+        const int32_t sheet = glyph.texture != nullptr ? glyph.sheet : -1;
+        records.push_back({ codepoint, sheet, glyph.bearingX, glyph.width, glyph.advance,
+                            glyph.texcoords });
+    }
+
+    bool success = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+    if (success && !records.empty())
+        success = std::fwrite(records.data(), sizeof(GlyphCacheRecord), records.size(), file) ==
+                  records.size();
+
+    return (std::fclose(file) == 0) && success;
+}
+
+bool GlyphTable::Load(const char* path)
+{
+    std::FILE* file = std::fopen(path, "rb");
+
+    if (!file)
+        return false;
+
+    GlyphCacheHeader header {};
+    std::vector<GlyphCacheRecord> records {};
+
+    std::fseek(file, 0, SEEK_END);
+    const long length = std::ftell(file);
+    std::rewind(file);
+
+    bool success = length >= (long)sizeof(header);
+    success      = success && std::fread(&header, sizeof(header), 1, file) == 1;
+
+    /* a cache built for another face is simply ignored */
+    success = success && header.magic == GLYPH_CACHE_MAGIC &&
+              header.version == GLYPH_CACHE_VERSION && header.faceSize == this->face->fileSize &&
+              header.faceHash == hashFace(this->face);
+
+    /* the records must fill the rest of the file exactly */
+    if (success)
+    {
+        const size_t remaining = length - sizeof(header);
+
+        success = remaining % sizeof(GlyphCacheRecord) == 0 &&
+                  remaining / sizeof(GlyphCacheRecord) == header.count;
+    }
+
+    if (success)
+    {
+        records.resize(header.count);
+        success = std::fread(records.data(), sizeof(GlyphCacheRecord), header.count, file) ==
+                  header.count;
+    }
+
+    std::fclose(file);
+
+    if (!success)
+        return false;
+
+    for (const auto& record : records)
+    {
+        if (record.sheet >= (int32_t)this->textures.size())
+            return false;
+    }
+
+    this->Reserve(records.size());
+
+    for (const auto& record : records)
+    {
+        Glyph glyph {};
+        glyph.texture   = record.sheet >= 0 ? &this->textures[record.sheet] : nullptr;
+        glyph.sheet     = std::max(record.sheet, 0);
+        glyph.bearingX  = record.bearingX;
+        glyph.width     = record.width;
+        glyph.advance   = record.advance;
+        glyph.texcoords = record.texcoords;
+
+        this->glyphs[record.codepoint] = glyph;
+    }
+
+    return true;
+}
@@ -2,6 +2,7 @@
 
 #include "drawcommand.hpp"
 #include "font.hpp"
+#include "frameallocator.hpp"
 
 #include "polyline/types/beveljoin.hpp"
 #include "polyline/types/miterjoin.hpp"
@@ -13,7 +14,7 @@ using namespace love;
 Graphics::Graphics()
 {
     this->transformStack.reserve(0x10);
-    this->transformStack.push_back(love::Matrix4 {});
+    this->transformStack.push_back(Affine2D {});
 
     this->state.reserve(0x0A);
     this->state.push_back(DisplayState {});
@@ -22,6 +23,42 @@ Graphics::Graphics()
     this->pixelScaleStack.push_back(1.0);
 }
 
+Graphics::~Graphics()
+{
+    if (this->lineRampCreated)
+        C3D_TexDelete(&this->lineRamp);
+}
+
+C3D_Tex* Graphics::GetLineRamp()
+{
+    if (this->lineRampCreated)
+        return &this->lineRamp;
+
+    const int size = love::Polyline::RAMP_SIZE;
+
+    if (!C3D_TexInit(&this->lineRamp, size, size, GPU_A8))
+        return nullptr;
+
+    auto* texels = (uint8_t*)this->lineRamp.data;
+
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            const auto index = Color::TileIndex(size, Vector2(x, y));
+            texels[index]    = love::Polyline::get_ramp_texel(x, y);
+        }
+    }
+
+    C3D_TexSetFilter(&this->lineRamp, GPU_LINEAR, GPU_LINEAR);
+    C3D_TexSetWrap(&this->lineRamp, GPU_CLAMP_TO_EDGE, GPU_CLAMP_TO_EDGE);
+    C3D_TexFlush(&this->lineRamp);
+
+    this->lineRampCreated = true;
+
+    return &this->lineRamp;
+}
+
 void Graphics::Polyline(const std::span<Vector2> points)
 {
 
@@ -32,29 +69,175 @@ void Graphics::Polyline(const std::span<Vector2> points)
     float pixelSize   = 1.0f / std::max((float)this->pixelScaleStack.back(), 0.000001f);
     bool shouldSmooth = lineStyle == LINE_SMOOTH;
 
+    /* ramp antialiasing needs texture coordinates, which only the batch path writes */
+    if (lineStyle == LINE_SMOOTH_RAMP)
+    {
+        const std::span<Vector2> lines[] = { points };
+        this->Lines(lines);
+
+        return;
+    }
+
     if (lineJoin == LINE_JOIN_NONE)
     {
         NoneJoinPolyline line;
-        line.render(points.data(), points.size(), halfWidth, pixelSize, shouldSmooth);
+        line.render(this->polylineScratch, points.data(), points.size(), halfWidth, pixelSize,
+                    shouldSmooth);
 
         line.draw(this);
     }
     else if (lineJoin == LINE_JOIN_BEVEL)
     {
         BevelJoinPolyline line;
-        line.render(points.data(), points.size(), halfWidth, pixelSize, shouldSmooth);
+        line.render(this->polylineScratch, points.data(), points.size(), halfWidth, pixelSize,
+                    shouldSmooth);
 
         line.draw(this);
     }
     else if (lineJoin == LINE_JOIN_MITER)
     {
         MiterJoinPolyline line;
-        line.render(points.data(), points.size(), halfWidth, pixelSize, shouldSmooth);
+        line.render(this->polylineScratch, points.data(), points.size(), halfWidth, pixelSize,
+                    shouldSmooth);
 
         line.draw(this);
     }
 }
 
+Graphics::LineBatch Graphics::BeginLines()
+{
+    LineBatch batch {};
+
+    batch.pixelSize = 1.0f / std::max((float)this->pixelScaleStack.back(), 0.000001f);
+    batch.smooth    = this->GetLineStyle() == LINE_SMOOTH;
+    batch.ramp      = this->GetLineStyle() == LINE_SMOOTH_RAMP;
+
+    /* without the texture the lines are still drawn, just not smoothed */
+    if (batch.ramp && this->GetLineRamp() == nullptr)
+        batch.ramp = false;
+
+    return batch;
+}
+
+/*
+** Tessellates @points straight into the frame vertex buffer. Vertices are
+** handed out in order, so each line lands right after the previous one and
+** two repeated vertices stitch it onto the batch's strip.
+*/
+bool Graphics::AppendLine(LineBatch& batch, std::span<Vector2> points, const Color& color,
+                          float width, LineJoin join)
+{
+    if (points.size() < 2)
+        return true;
+
+    const float halfWidth = width * 0.5f;
+
+    NoneJoinPolyline noneJoin;
+    BevelJoinPolyline bevelJoin;
+    MiterJoinPolyline miterJoin;
+
+    love::Polyline* line = nullptr;
+
+    switch (join)
+    {
+        case LINE_JOIN_NONE:
+            noneJoin.render(this->polylineScratch, points.data(), points.size(), halfWidth,
+                            batch.pixelSize, batch.smooth, batch.ramp);
+            line = &noneJoin;
+            break;
+        case LINE_JOIN_BEVEL:
+            bevelJoin.render(this->polylineScratch, points.data(), points.size(), halfWidth,
+                             batch.pixelSize, batch.smooth, batch.ramp);
+            line = &bevelJoin;
+            break;
+        case LINE_JOIN_MITER:
+        default:
+            miterJoin.render(this->polylineScratch, points.data(), points.size(), halfWidth,
+                             batch.pixelSize, batch.smooth, batch.ramp);
+            line = &miterJoin;
+            break;
+    }
+
+    const size_t count  = line->get_total_vertex_count();
+    const size_t stitch = batch.count > 0 ? 2 : 0;
+
+    if (count == 0)
+        return true;
+
+    int first = 0;
+    auto* out = Renderer::Instance().GetVertices(count + stitch, first);
+
+    if (out == nullptr)
+    {
+        LOG("Frame vertex buffer is full, dropping %zu line vertices", count + stitch);
+        return false;
+    }
+
+    if (batch.count == 0)
+        batch.first = first;
+
+    line->write_vertices(out + stitch, this->GetTransform(), color, 0, count);
+
+    if (stitch > 0)
+    {
+        out[0] = out[-1];
+        out[1] = out[2];
+    }
+
+    batch.count += count + stitch;
+
+    return true;
+}
+
+void Graphics::EndLines(const LineBatch& batch)
+{
+    if (batch.count == 0)
+        return;
+
+    /* the text environment multiplies the vertex alpha by the ramp's */
+    auto texEnv = DrawCommand::TEXENV_MODE_PRIMITIVE;
+
+    if (batch.ramp)
+        texEnv = DrawCommand::TEXENV_MODE_TEXT;
+
+    DrawCommand command(batch.count, batch.first, texEnv, vertex::PRIMITIVE_TRIANGLE_STRIP);
+
+    if (batch.ramp)
+        command.handles = { this->GetLineRamp() };
+
+    Renderer::Instance().Render(command);
+}
+
+void Graphics::Lines(std::span<const Line> lines)
+{
+    auto batch = this->BeginLines();
+
+    for (const auto& line : lines)
+    {
+        if (!this->AppendLine(batch, line.points, line.color, line.width, line.join))
+            break;
+    }
+
+    this->EndLines(batch);
+}
+
+void Graphics::Lines(std::span<const std::span<Vector2>> lines)
+{
+    const Color color   = this->GetColor();
+    const float width   = this->GetLineWidth();
+    const LineJoin join = this->GetLineJoin();
+
+    auto batch = this->BeginLines();
+
+    for (const auto& points : lines)
+    {
+        if (!this->AppendLine(batch, points, color, width, join))
+            break;
+    }
+
+    this->EndLines(batch);
+}
+
 void Graphics::Polyfill(DrawMode mode, std::span<love::Vector2> points, const Color& color,
                         bool skipLastVertex)
 {
@@ -64,18 +247,42 @@ void Graphics::Polyfill(DrawMode mode, std::span<love::Vector2> points, const Co
     }
     else
     {
-        const auto transform = transformStack.back();
-        bool is2D            = transform.IsAffine2DTransform();
+        /* the skipped last vertex must not wrap the count around */
+        if (points.size() <= (skipLastVertex ? 1u : 0u))
+            return;
+
+        const size_t count   = points.size() - (skipLastVertex ? 1 : 0);
+        const auto triangles = this->triangulator.Triangulate(points.first(count));
+
+        if (triangles.empty())
+            return;
+
+        auto& renderer = Renderer::Instance();
+
+        int first       = 0;
+        auto* vertices  = renderer.GetFixedColorVertices(count, first);
+        uint16_t* index = vertices ? renderer.GetIndices(triangles.size()) : nullptr;
+
+        if (index == nullptr)
+        {
+            LOG("Frame vertex buffer is full, dropping a %zu point polygon", count);
+            return;
+        }
+
+        this->GetTransform().TransformPositions(vertices, points.data(), (int)count);
 
-        const int count = points.size() - (skipLastVertex ? 1 : 0);
-        DrawCommand command(count);
+        for (size_t i = 0; i < count; i++)
+            vertices[i].texcoord = { 0, 0 };
 
-        if (is2D)
-            transform.TransformXY(command.Positions().get(), points.data(), command.count);
+        for (size_t i = 0; i < triangles.size(); i++)
+            index[i] = (uint16_t)(first + triangles[i]);
 
-        command.FillVertices(color);
+        DrawCommand command(triangles.size(), first, DrawCommand::TEXENV_MODE_PRIMITIVE,
+                            vertex::PRIMITIVE_TRIANGLES);
+        command.indices    = index;
+        command.fixedColor = color;
 
-        love::Renderer::Instance().Render(command);
+        renderer.Render(command);
     }
 }
 
@@ -89,6 +296,25 @@ void Graphics::Rectangle(DrawMode mode, float x, float y, float width, float hei
     this->Polyfill(mode, points, color);
 }
 
+/*
+** Writes @count points of the unit circle @step radians apart, starting at @angle.
+** Each point is the previous one rotated by @step, so only the first needs cosf/sinf.
+*/
+static void UnitArc(love::Vector2* points, int count, float angle, float step)
+{
+    const float cosStep = cosf(step);
+    const float sinStep = sinf(step);
+
+    love::Vector2 point(cosf(angle), sinf(angle));
+
+    for (int index = 0; index < count; index++)
+    {
+        points[index] = point;
+        point         = love::Vector2(point.x * cosStep - point.y * sinStep,
+                                      point.x * sinStep + point.y * cosStep);
+    }
+}
+
 void Graphics::Rectangle(DrawMode mode, float x, float y, float width, float height, float rx,
                          float ry, int points, const Color& color)
 {
@@ -111,82 +337,82 @@ void Graphics::Rectangle(DrawMode mode, float x, float y, float width, float hei
 
     int pointCount = (points + 2) * 4;
 
-    love::Vector2 coords[pointCount + 1] {};
-    float phi = 0.0f;
+    auto& allocator = FrameAllocator::Instance();
+    auto* coords    = allocator.Allocate<love::Vector2>(pointCount + 1);
 
-    for (int index = 0; index <= points + 2; ++index, phi += angleShift)
-    {
-        coords[index].x = x + rx * (1 - cosf(phi));
-        coords[index].y = y + ry * (1 - sinf(phi));
-    }
+    /* every corner steps through the same angles, a quarter turn apart */
+    auto* quarter = allocator.Allocate<love::Vector2>(points + 2);
+    UnitArc(quarter, points + 2, 0.0f, angleShift);
 
-    phi = halfPi;
-
-    for (int index = points + 2; index <= 2 * (points + 2); ++index, phi += angleShift)
+    for (int index = 0; index < points + 2; ++index)
     {
-        coords[index].x = x + width - rx * (1 + cosf(phi));
-        coords[index].y = y + ry * (1 - sinf(phi));
-    }
+        const float c = quarter[index].x;
+        const float s = quarter[index].y;
 
-    phi = 2 * halfPi;
+        coords[index].x = x + rx * (1 - c);
+        coords[index].y = y + ry * (1 - s);
 
-    for (int index = 2 * (points + 2); index <= 3 * (points + 2); ++index, phi += angleShift)
-    {
-        coords[index].x = x + width - rx * (1 + cosf(phi));
-        coords[index].y = y + height - ry * (1 + sinf(phi));
-    }
+        coords[index + (points + 2)].x = x + width - rx * (1 - s);
+        coords[index + (points + 2)].y = y + ry * (1 - c);
 
-    phi = 3 * halfPi;
+        coords[index + 2 * (points + 2)].x = x + width - rx * (1 - c);
+        coords[index + 2 * (points + 2)].y = y + height - ry * (1 - s);
 
-    for (int index = 3 * (points + 2); index <= 4 * (points + 2); ++index, phi += angleShift)
-    {
-        coords[index].x = x + rx * (1 - cosf(phi));
-        coords[index].y = y + height - ry * (1 + sinf(phi));
+        coords[index + 3 * (points + 2)].x = x + rx * (1 - s);
+        coords[index + 3 * (points + 2)].y = y + height - ry * (1 - c);
     }
 
     coords[pointCount] = coords[0];
     this->Polyfill(mode, std::span(coords, pointCount + 1), color);
 }
 
-int Graphics::CalculateEllipsePoints(float rx, float ry)
+void Graphics::Rectangle(DrawMode mode, float x, float y, float width, float height, float rx,
+                         float ry, const Color& color)
 {
-    auto pixelScale = 1.0f;
-    auto points     = sqrtf(((rx + ry) / 2.0f) * 20.0f * pixelScale);
+    const int points = this->CalculateEllipsePoints(std::min(rx, fabsf(width / 2)),
+                                                    std::min(ry, fabsf(height / 2)));
+
+    this->Rectangle(mode, x, y, width, height, rx, ry, points, color);
+}
+
+int Graphics::CalculateEllipsePoints(float rx, float ry) const
+{
+    /*
+    ** A chord spanning theta of a circle of radius r strays r * (1 - cos(theta / 2))
+    ** from the edge; use the larger radius, in pixels, so the bound holds all around.
+    */
+    const float scale  = (float)this->pixelScaleStack.back();
+    const float radius = std::max(fabsf(rx), fabsf(ry)) * scale;
+
+    if (radius <= ELLIPSE_PIXEL_ERROR)
+        return MIN_ELLIPSE_POINTS;
+
+    const float points = (float)LOVE_M_PI / acosf(1.0f - ELLIPSE_PIXEL_ERROR / radius);
 
-    return std::max(points, 8.0f);
+    return std::clamp((int)ceilf(points), MIN_ELLIPSE_POINTS, MAX_ELLIPSE_POINTS);
 }
 
 void Graphics::Ellipse(DrawMode mode, float x, float y, float a, float b, int points,
                        const Color& color)
 {
-    float twoPi = (float)(LOVE_M_TAU);
-
     if (points <= 0)
         points = 1;
 
-    const float angleShift = (twoPi / points);
-    float phi              = 0.0f;
-
-    int extraPoints = 1 + (mode == DRAW_FILL ? 1 : 0);
-    love::Vector2 polygonCoords[points + extraPoints] {};
-    love::Vector2* coords = polygonCoords;
+    const float angleShift = (float)LOVE_M_TAU / points;
 
-    if (mode == DRAW_FILL)
-    {
-        coords[0].x = x;
-        coords[0].y = y;
-        coords++;
-    }
+    auto* coords = FrameAllocator::Instance().Allocate<love::Vector2>(points + 1);
+    UnitArc(coords, points, 0.0f, angleShift);
 
-    for (int index = 0; index < points; ++index, phi += angleShift)
+    for (int index = 0; index < points; ++index)
     {
-        coords[index].x = x + a * cosf(phi);
-        coords[index].y = y + b * sinf(phi);
+        coords[index].x = x + a * coords[index].x;
+        coords[index].y = y + b * coords[index].y;
     }
 
     coords[points] = coords[0];
 
-    this->Polyfill(mode, std::span(polygonCoords, points + extraPoints), color, false);
+    /* an ellipse is convex, so filling the outline alone triangulates as a fan */
+    this->Polyfill(mode, std::span(coords, points + 1), color);
 }
 
 void Graphics::Ellipse(DrawMode mode, float x, float y, float a, float b, const Color& color)
@@ -228,18 +454,18 @@ void Graphics::Arc(DrawMode mode, ArcMode arcMode, float x, float y, float radiu
     if (mode == DRAW_FILL && arcMode == ARC_OPEN)
         arcMode = ARC_CLOSED;
 
-    float phi = angle1;
-
     love::Vector2* coords = nullptr;
     int numCoords         = 0;
 
     // clang-format off
     const auto createPoints = [&](love::Vector2* coordinates)
     {
-        for (int index = 0; index <= points; ++index, phi += angleShift)
+        UnitArc(coordinates, points + 1, angle1, angleShift);
+
+        for (int index = 0; index <= points; ++index)
         {
-            coordinates[index].x = x + radius * cosf(phi);
-            coordinates[index].y = y + radius * sinf(phi);
+            coordinates[index].x = x + radius * coordinates[index].x;
+            coordinates[index].y = y + radius * coordinates[index].y;
         }
     };
     // clang-format on
@@ -247,7 +473,7 @@ void Graphics::Arc(DrawMode mode, ArcMode arcMode, float x, float y, float radiu
     if (arcMode == ARC_PIE)
     {
         numCoords = points + 3;
-        coords    = new love::Vector2[numCoords];
+        coords    = FrameAllocator::Instance().Allocate<love::Vector2>(numCoords);
 
         coords[0] = coords[numCoords - 1] = love::Vector2(x, y);
         createPoints(coords + 1);
@@ -255,21 +481,20 @@ void Graphics::Arc(DrawMode mode, ArcMode arcMode, float x, float y, float radiu
     else if (arcMode == ARC_OPEN)
     {
         numCoords = points + 1;
-        coords    = new love::Vector2[numCoords];
+        coords    = FrameAllocator::Instance().Allocate<love::Vector2>(numCoords);
 
         createPoints(coords);
     }
     else
     {
         numCoords = points + 2;
-        coords    = new love::Vector2[numCoords];
+        coords    = FrameAllocator::Instance().Allocate<love::Vector2>(numCoords);
 
         createPoints(coords);
         coords[numCoords - 1] = coords[0];
     }
 
     this->Polyfill(mode, std::span(coords, numCoords), color);
-    delete[] coords;
 }
 
 void Graphics::Arc(DrawMode mode, ArcMode arcMode, float x, float y, float radius, float angle1,
@@ -49,50 +49,14 @@ int main(int argc, char** argv)
 
     auto& instance = love::FontModule::Instance();
 
-    std::unique_ptr<uint8_t[]> fontData;
-    long fileSize = 0;
-
     std::string directory = std::filesystem::current_path();
     directory += std::string("coolvetica.bcfnt");
 
     const char* filepath = directory.c_str();
     LOG("%s", filepath);
 
-    {
-        FILE* file = std::fopen(filepath, "r");
-
-        if (!file)
-        {
-            std::fclose(file);
-            throw love::Exception("File does not exist.");
-        }
-
-        std::fseek(file, 0, SEEK_END);
-        fileSize = std::ftell(file);
-        std::rewind(file);
-        LOG("%ld", fileSize);
-
-        try
-        {
-            fontData = std::make_unique<uint8_t[]>(fileSize);
-        }
-        catch (std::bad_alloc&)
-        {
-            throw love::Exception("Out of memory.");
-        }
-
-        long read = (long)std::fread(fontData.get(), 1, fileSize, file);
-        LOG("%ld", read);
-        if (read != fileSize)
-        {
-            std::fclose(file);
-            throw love::Exception("Failed to read font");
-        }
-        LOG("!");
-    }
-
-    StrongReference<Rasterizer> rasterizer(instance.NewRasterizer(fontData.get(), fileSize, 22),
-                                           Acquire::NORETAIN);
+    /* read straight into linear memory, no intermediate heap copy */
+    StrongReference<Rasterizer> rasterizer(instance.NewRasterizer(filepath, 22), Acquire::NORETAIN);
 
     auto* font      = new love::Font(rasterizer.Get());
     float textAngle = 0.0f;
@@ -29,19 +29,26 @@
 
 using namespace love;
 
-void Polyline::render(const Vector2* coords, size_t count, size_t size_hint, float halfwidth,
-                      float pixel_size, bool draw_overdraw)
+void Polyline::render(Scratch& scratch, const Vector2* coords, size_t count, size_t size_hint,
+                      float halfwidth, float pixel_size, bool draw_overdraw, bool draw_ramp)
 {
-    static std::vector<Vector2> anchors;
+    auto& anchors = scratch.anchors;
     anchors.clear();
     anchors.reserve(size_hint);
 
-    static std::vector<Vector2> normals;
+    auto& normals = scratch.normals;
     normals.clear();
     normals.reserve(size_hint);
 
     // prepare vertex arrays
-    if (draw_overdraw)
+    if (draw_ramp)
+    {
+        // half a pixel wider on each side; the ramp fades that pixel out
+        draw_overdraw = false;
+        halfwidth += pixel_size * 0.5f;
+        ramp_width = 2.0f * halfwidth / pixel_size;
+    }
+    else if (draw_overdraw)
         halfwidth -= pixel_size * 0.3f;
 
     // compute sleeve
@@ -85,7 +92,10 @@ void Polyline::render(const Vector2* coords, size_t count, size_t size_hint, flo
     }
 
     // Use a single linear array for both the regular and overdraw vertices.
-    vertices = new Vector2[vertex_count + extra_vertices + overdraw_vertex_count];
+    // Clearing first zeroes any slot the joins leave unwritten.
+    scratch.vertices.clear();
+    scratch.vertices.resize(vertex_count + extra_vertices + overdraw_vertex_count);
+    vertices = scratch.vertices.data();
 
     for (size_t i = 0; i < vertex_count; ++i)
         vertices[i] = anchors[i] + normals[i];
@@ -156,78 +166,137 @@ void Polyline::render_overdraw(const std::vector<Vector2>& normals, float pixel_
     }
 }
 
-Polyline::~Polyline()
-{
-    if (vertices)
-        delete[] vertices;
-}
-
 void Polyline::draw(Graphics* gfx)
 {
-    const auto& t  = gfx->GetTransform();
-    bool is2D      = t.IsAffine2DTransform();
-    Color curcolor = gfx->GetColor();
+    auto& renderer = Renderer::Instance();
 
-    int overdraw_start = (int)overdraw_vertex_start;
-    int overdraw_count = (int)overdraw_vertex_count;
+    const size_t total = get_total_vertex_count();
 
-    int total_vertex_count = (int)vertex_count;
-    if (overdraw)
-        total_vertex_count = overdraw_start + overdraw_count;
-
-    // love's automatic batching can only deal with < 65k vertices per draw.
+    // A draw can only index < 65k vertices.
     // uint16_max - 3 is evenly divisible by 6 (needed for quads mode).
-    int maxvertices = LOVE_UINT16_MAX - 3;
+    const size_t max_vertices = LOVE_UINT16_MAX - 3;
 
-    int advance = maxvertices;
+    // Consecutive triangle strips share two vertices so no triangle is lost.
+    size_t advance = max_vertices;
     if (triangle_mode == vertex::TRIANGLE_STRIP)
         advance -= 2;
 
-    for (int vertex_start = 0; vertex_start < total_vertex_count; vertex_start += advance)
+    for (size_t start = 0; start < total; start += advance)
     {
-        const Vector2* verts = vertices + vertex_start;
+        const size_t count = std::min(max_vertices, total - start);
+        int first          = 0;
 
-        int totalVertices = std::min(maxvertices, total_vertex_count - vertex_start);
+        // Without overdraw, every vertex has the line's color.
+        if (!overdraw)
+        {
+            vertex::FixedColorVertex* out = renderer.GetFixedColorVertices(count, first);
 
-        auto mode = vertex::PRIMITIVE_TRIANGLE_STRIP;
-        if (this->triangle_mode == vertex::TRIANGLE_QUADS)
-            mode = vertex::PRIMITIVE_TRIANGLE_STRIP;
+            if (out == nullptr)
+            {
+                LOG("Frame vertex buffer is full, dropping %zu line vertices", total - start);
+                return;
+            }
 
-        DrawCommand command(totalVertices, mode);
+            write_vertices(out, gfx->GetTransform(), start, count);
+        }
+        else
+        {
+            vertex::Vertex* out = renderer.GetVertices(count, first);
 
-        if (is2D)
-            t.TransformXY(command.Positions().get(), verts, totalVertices);
+            if (out == nullptr)
+            {
+                LOG("Frame vertex buffer is full, dropping %zu line vertices", total - start);
+                return;
+            }
 
-        Color colordata[totalVertices] {};
+            write_vertices(out, gfx->GetTransform(), gfx->GetColor(), start, count);
+        }
 
-        int draw_rough_count = std::min((int)command.count, (int)vertex_count - vertex_start);
+        DrawCommand command(count, first, DrawCommand::TEXENV_MODE_PRIMITIVE,
+                            vertex::PRIMITIVE_TRIANGLE_STRIP);
 
-        // Constant vertex color up to the overdraw vertices.
-        for (int i = 0; i < draw_rough_count; i++)
-            colordata[i] = curcolor;
+        if (!overdraw)
+            command.fixedColor = gfx->GetColor();
 
-        if (overdraw)
-        {
-            int draw_remaining_count = command.count - draw_rough_count;
+        renderer.Render(command);
 
-            int draw_overdraw_begin = overdraw_start - vertex_start;
-            int draw_overdraw_end   = draw_overdraw_begin + overdraw_count;
+        if (start + count >= total)
+            break;
+    }
+}
 
-            draw_overdraw_begin = std::max(0, draw_overdraw_begin);
+size_t Polyline::get_total_vertex_count() const
+{
+    if (overdraw)
+        return overdraw_vertex_start + overdraw_vertex_count;
 
-            int draw_overdraw_count =
-                std::min(draw_remaining_count, draw_overdraw_end - draw_overdraw_begin);
+    return vertex_count;
+}
 
-            if (draw_overdraw_count > 0)
-            {
-                Color* colors = colordata + draw_overdraw_begin;
-                fill_color_array(curcolor, colors, draw_overdraw_count);
-            }
-        }
+std::array<float, 2> Polyline::get_ramp_texcoord(size_t index) const
+{
+    if (!is_ramp())
+        return { 0, 0 };
+
+    // Ramp coordinates count pixels to the right and left edge, offset by
+    // half a texel so that an edge samples the center of a transparent texel.
+    const float near = 0.5f / RAMP_SIZE;
+    const float far  = (ramp_width + 0.5f) / RAMP_SIZE;
+
+    return on_left_edge(index) ? std::array { near, far } : std::array { far, near };
+}
+
+void Polyline::write_vertices(vertex::FixedColorVertex* out, const Affine2D& transform,
+                              size_t start, size_t count)
+{
+    transform.TransformPositions(out, vertices + start, (int)count);
+
+    for (size_t i = 0; i < count; i++)
+        out[i].texcoord = get_ramp_texcoord(start + i);
+}
+
+void Polyline::write_vertices(vertex::Vertex* out, const Affine2D& transform, const Color& color,
+                              size_t start, size_t count)
+{
+    const auto array = color.array();
+
+    transform.TransformPositions(out, vertices + start, (int)count);
 
-        command.FillVertices(colordata);
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i].color    = array;
+        out[i].texcoord = get_ramp_texcoord(start + i);
+    }
+
+    if (!overdraw)
+        return;
+
+    // The fade patterns repeat every four vertices, so filling the overdraw
+    // colors in chunks of a multiple of four gives the same result as one pass.
+    // Only the chunks overlapping [start, start + count) are filled.
+    const size_t end = start + count;
+    Color colors[64];
+
+    for (size_t chunk = 0; chunk < overdraw_vertex_count; chunk += 64)
+    {
+        const size_t chunk_start = overdraw_vertex_start + chunk;
+        const int chunk_count    = (int)std::min<size_t>(64, overdraw_vertex_count - chunk);
 
-        Renderer::Instance().Render(command);
+        if (chunk_start + chunk_count <= start)
+            continue;
+
+        if (chunk_start >= end)
+            break;
+
+        fill_color_array(color, colors, chunk_count);
+
+        for (int i = 0; i < chunk_count; i++)
+        {
+            const size_t index = chunk_start + i;
+
+            if (index >= start && index < end)
+                out[index - start].color = colors[i].array();
+        }
     }
 }
 
@@ -10,7 +10,7 @@ using namespace love;
 
 Rasterizer::Rasterizer(CFG_Region region, float size) : glyphCount(-1), metrics {}
 {
-    this->face = FontModule::LoadSystemFont(region);
+    this->face = FontModule::LoadSystemFont(region, &this->index);
 
     FINF_s* info   = fontGetInfo(this->face);
     TGLP_s* sheets = info->tglp;
@@ -24,10 +24,20 @@ Rasterizer::Rasterizer(CFG_Region region, float size) : glyphCount(-1), metrics
     this->metrics.height  = sheets->cellHeight * this->scale;
 }
 
-Rasterizer::Rasterizer(const void* data, size_t dataSize, float size)
+Rasterizer::Rasterizer(const void* data, size_t dataSize, float size) : glyphCount(-1), metrics {}
 {
-    this->face = FontModule::LoadFromFile(data, dataSize);
+    this->face = FontModule::LoadFromFile(data, dataSize, &this->index);
+    this->SetFileMetrics(size);
+}
+
+Rasterizer::Rasterizer(const char* path, float size) : glyphCount(-1), metrics {}
+{
+    this->face = FontModule::LoadFromPath(path, &this->index);
+    this->SetFileMetrics(size);
+}
 
+void Rasterizer::SetFileMetrics(float size)
+{
     FINF_s* info   = fontGetInfo(this->face);
     TGLP_s* sheets = info->tglp;
 
@@ -40,33 +50,73 @@ Rasterizer::Rasterizer(const void* data, size_t dataSize, float size)
     this->metrics.height  = sheets->cellHeight * this->scale;
 }
 
+Rasterizer::Rasterizer(Rasterizer* base, float size) :
+    glyphCount(-1),
+    metrics {},
+    face(base->face),
+    base(base)
+{
+    this->SetFileMetrics(size);
+}
+
 Rasterizer::~Rasterizer()
 {
-    if (this->face)
-        linearFree(this->face);
+    /* a shared face belongs to the base Rasterizer */
+    if (!this->base)
+        FontModule::FreeFont(this->face);
 }
 
-GlyphData* Rasterizer::GetGlyphData(uint32_t glyph) const
+int Rasterizer::GetGlyphIndex(uint32_t glyph) const
+{
+    const auto& index = this->GetIndex();
+
+    if (index.IsBuilt())
+        return index.GetGlyphIndex(glyph);
+
+    return fontGlyphIndexFromCodePoint(this->face, glyph);
+}
+
+void Rasterizer::GetGlyphMetrics(uint32_t glyph, GlyphData::GlyphMetrics& metrics,
+                                 GlyphData::GlyphSheetInfo& info) const
+{
+    this->GetGlyphMetrics(glyph, this->scale, metrics, info);
+}
+
+void Rasterizer::GetGlyphMetrics(uint32_t glyph, float scale, GlyphData::GlyphMetrics& metrics,
+                                 GlyphData::GlyphSheetInfo& info) const
 {
-    GlyphData::GlyphMetrics metrics {};
     fontGlyphPos_s out;
 
-    int index = fontGlyphIndexFromCodePoint(this->face, glyph);
-    fontCalcGlyphPos(&out, this->face, index, GLYPH_POS_CALC_VTXCOORD, this->scale, this->scale);
+    const auto& fontIndex = this->GetIndex();
+    int index             = this->GetGlyphIndex(glyph);
 
-    metrics.height   = this->metrics.height;
+    if (fontIndex.IsBuilt())
+        fontIndex.CalcGlyphPos(&out, index, scale, scale);
+    else
+        fontCalcGlyphPos(&out, this->face, index, GLYPH_POS_CALC_VTXCOORD, scale, scale);
+
+    const auto* fontInfo = fontGetInfo(this->face);
+
+    metrics.height   = fontInfo->tglp->cellHeight * scale;
     metrics.width    = out.width;
     metrics.advance  = out.xAdvance;
     metrics.bearingX = out.xOffset;
-    metrics.bearingY = this->metrics.ascent;
+    metrics.bearingY = fontInfo->ascent * scale;
 
-    GlyphData::GlyphSheetInfo info {};
     info.index = out.sheetIndex;
 
     info.top    = out.texcoord.top;
     info.left   = out.texcoord.left;
     info.right  = out.texcoord.right;
     info.bottom = out.texcoord.bottom;
+}
+
+GlyphData* Rasterizer::GetGlyphData(uint32_t glyph) const
+{
+    GlyphData::GlyphMetrics metrics {};
+    GlyphData::GlyphSheetInfo info {};
+
+    this->GetGlyphMetrics(glyph, metrics, info);
 
     return new GlyphData(glyph, metrics, info);
 }
@@ -89,7 +139,7 @@ GlyphData* Rasterizer::GetGlyphData(std::string_view text) const
 
 const bool Rasterizer::HasGlyph(uint32_t glyph) const
 {
-    int index        = fontGlyphIndexFromCodePoint(this->face, glyph);
+    int index        = this->GetGlyphIndex(glyph);
     const auto* info = fontGetInfo(this->face);
 
     return index != info->alterCharIndex;
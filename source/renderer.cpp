@@ -1,11 +1,22 @@
 #include "renderer.hpp"
 #include "shader.hpp"
 
+#include "frameallocator.hpp"
 #include "logfile.hpp"
 
 using namespace love;
 
-Renderer::Renderer() : current(nullptr), currentTexture(nullptr), inFrame(false)
+Renderer::Renderer() :
+    current(nullptr),
+    currentTexture(nullptr),
+    inFrame(false),
+    vertices(MAX_VERTICES * VERTEX_SIZE),
+    vertexCount(0),
+    fixedColorVertices(MAX_VERTICES * FIXED_COLOR_VERTEX_SIZE, FIXED_COLOR_VERTEX_SIZE, 2, 0x10),
+    fixedColorVertexCount(0),
+    fixedColorLayout(false),
+    indices((uint16_t*)linearAlloc(MAX_INDICES * sizeof(uint16_t))),
+    indexCount(0)
 {
     gfxInitDefault();
     C3D_Init(C3D_DEFAULT_CMDBUF_SIZE * 2);
@@ -16,16 +27,26 @@ Renderer::Renderer() : current(nullptr), currentTexture(nullptr), inFrame(false)
     C3D_CullFace(GPU_CULL_NONE);
     C3D_DepthTest(true, GPU_GEQUAL, GPU_WRITE_ALL);
 
-    C3D_AttrInfo* attributes = C3D_GetAttrInfo();
-    AttrInfo_Init(attributes);
+    AttrInfo_Init(&this->vertexAttributes);
 
-    AttrInfo_AddLoader(attributes, 0, GPU_FLOAT, 3); // position
-    AttrInfo_AddLoader(attributes, 1, GPU_FLOAT, 4); // color
-    AttrInfo_AddLoader(attributes, 2, GPU_FLOAT, 2); // texcoord
+    AttrInfo_AddLoader(&this->vertexAttributes, 0, GPU_FLOAT, 3); // position
+    AttrInfo_AddLoader(&this->vertexAttributes, 1, GPU_FLOAT, 4); // color
+    AttrInfo_AddLoader(&this->vertexAttributes, 2, GPU_FLOAT, 2); // texcoord
+
+    AttrInfo_Init(&this->fixedColorAttributes);
+
+    AttrInfo_AddLoader(&this->fixedColorAttributes, 0, GPU_FLOAT, 3); // position
+    AttrInfo_AddLoader(&this->fixedColorAttributes, 2, GPU_FLOAT, 2); // texcoord
+    AttrInfo_AddFixed(&this->fixedColorAttributes, 1);                // color
+
+    C3D_SetAttrInfo(&this->vertexAttributes);
 }
 
 Renderer::~Renderer()
 {
+    if (this->indices != nullptr)
+        linearFree(this->indices);
+
     C3D_Fini();
     gfxExit();
 }
@@ -36,8 +57,12 @@ void Renderer::BindFramebuffer(size_t index)
     {
         C3D_FrameBegin(C3D_FRAME_SYNCDRAW);
 
-        this->commands.clear();
-        this->inFrame = true;
+        this->vertexCount           = 0;
+        this->fixedColorVertexCount = 0;
+        this->indexCount            = 0;
+        this->inFrame               = true;
+
+        Renderer::frame++;
     }
 
     this->current = &this->framebuffers[index];
@@ -55,8 +80,20 @@ void Renderer::Present()
 {
     if (this->inFrame)
     {
+        /* everything written to the frame vertex buffer gets flushed once */
+        if (this->vertexCount > 0)
+            this->vertices.FlushDataCache(this->vertexCount);
+
+        if (this->fixedColorVertexCount > 0)
+            this->fixedColorVertices.FlushDataCache(this->fixedColorVertexCount);
+
+        if (this->indexCount > 0)
+            GSPGPU_FlushDataCache(this->indices, this->indexCount * sizeof(uint16_t));
+
         C3D_FrameEnd(0);
         this->inFrame = false;
+
+        FrameAllocator::Instance().Reset();
     }
 }
 
@@ -72,11 +109,55 @@ bool Renderer::CheckHandle(C3D_Tex* texture)
     return true;
 }
 
+Vertex* Renderer::GetVertices(size_t count, int& first)
+{
+    if (this->vertexCount + count > this->vertices.GetCapacity())
+        return nullptr;
+
+    first = (int)this->vertexCount;
+    this->vertexCount += count;
+
+    return this->vertices.GetData() + first;
+}
+
+FixedColorVertex* Renderer::GetFixedColorVertices(size_t count, int& first)
+{
+    if (this->fixedColorVertexCount + count > this->fixedColorVertices.GetCapacity())
+        return nullptr;
+
+    first = (int)this->fixedColorVertexCount;
+    this->fixedColorVertexCount += count;
+
+    return this->fixedColorVertices.GetData<FixedColorVertex>() + first;
+}
+
+uint16_t* Renderer::GetIndices(size_t count)
+{
+    if (this->indices == nullptr || this->indexCount + count > MAX_INDICES)
+        return nullptr;
+
+    auto* indices = this->indices + this->indexCount;
+    this->indexCount += count;
+
+    return indices;
+}
+
+void Renderer::SetFixedColorLayout(bool fixedColor)
+{
+    if (this->fixedColorLayout == fixedColor)
+        return;
+
+    C3D_SetAttrInfo(fixedColor ? &this->fixedColorAttributes : &this->vertexAttributes);
+    this->fixedColorLayout = fixedColor;
+}
+
 bool Renderer::Render(DrawCommand& command)
 {
     love::Shader::defaults[love::Shader::STANDARD_DEFAULT]->Attach();
 
-    if (!command.buffer->IsValid())
+    auto& buffer = command.fixedColor ? this->fixedColorVertices : this->vertices;
+
+    if (!buffer.IsValid())
         return false;
 
     if (command.handles.size() > 0)
@@ -87,10 +168,21 @@ bool Renderer::Render(DrawCommand& command)
 
     auto mode = vertex::GetMode(command.mode);
 
-    C3D_SetBufInfo(command.buffer->GetBuffer());
-    C3D_DrawArrays(mode, 0, command.count);
+    this->SetFixedColorLayout(command.fixedColor.has_value());
+
+    if (command.fixedColor)
+    {
+        const auto& color = *command.fixedColor;
+        *C3D_FixedAttribGetWritePtr(FIXED_COLOR_ATTRIBUTE) =
+            FVec4_New(color.r, color.g, color.b, color.a);
+    }
+
+    C3D_SetBufInfo(buffer.GetBuffer());
 
-    this->commands.push_back(command.buffer);
+    if (command.indices != nullptr)
+        C3D_DrawElements(mode, command.count, C3D_UNSIGNED_SHORT, command.indices);
+    else
+        C3D_DrawArrays(mode, command.first, command.count);
 
     return true;
 }
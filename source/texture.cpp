@@ -1,83 +1,183 @@
 #include "texture.hpp"
 #include "logfile.hpp"
 #include "renderer.hpp"
+#include "texturecache.hpp"
 
+#include <algorithm>
 #include <cstdio>
+#include <memory>
 
 using namespace love;
 
-Texture::Texture(const std::string& path) : valid(false)
-{
-    FILE* file = std::fopen(path.c_str(), "rb");
+static constexpr size_t FILE_BUFFER_SIZE = 0x10000;
 
-    if (!file)
+static PixelFormat getPixelFormat(GPU_TEXCOLOR format)
+{
+    switch (format)
     {
-        std::fclose(file);
-        return;
+        case GPU_RGBA8:
+            return PIXELFORMAT_RGBA8_UNORM;
+        case GPU_RGB8:
+            return PIXELFORMAT_RGB8;
+        case GPU_RGBA5551:
+            return PIXELFORMAT_RGB5A1_UNORM;
+        case GPU_RGB565:
+            return PIXELFORMAT_RGB565_UNORM;
+        case GPU_RGBA4:
+            return PIXELFORMAT_RGBA4_UNORM;
+        case GPU_LA8:
+            return PIXELFORMAT_LA8_UNORM;
+        case GPU_HILO8:
+            return PIXELFORMAT_RG8_UNORM;
+        case GPU_L8:
+        case GPU_A8:
+            return PIXELFORMAT_R8_UNORM;
+        case GPU_ETC1:
+            return PIXELFORMAT_ETC1_UNORM;
+        case GPU_ETC1A4: /* 8 bits per pixel in 4x4 blocks, like ETC2 with alpha */
+            return PIXELFORMAT_ETC2_RGBA_UNORM;
+        default:
+            return PIXELFORMAT_UNKNOWN;
     }
+}
 
-    std::fseek(file, 0, SEEK_END);
-    long size = std::ftell(file);
-    std::rewind(file);
-
-    auto fdata = std::make_unique<uint8_t[]>(size);
-    auto read  = (long)std::fread(fdata.get(), 1, size, file);
+Texture::Texture(const std::string& path) :
+    path(path),
+    width(0),
+    height(0),
+    texture(nullptr),
+    quad(nullptr),
+    format(PIXELFORMAT_UNKNOWN),
+    size(0),
+    lastFrame(0),
+    cached(false),
+    valid(false)
+{
+    this->valid = this->Load();
 
-    if (read != size)
-    {
-        std::fclose(file);
+    if (!this->valid)
         return;
-    }
 
-    this->texture           = new C3D_Tex();
-    Tex3DS_Texture imported = Tex3DS_TextureImport(fdata.get(), size, this->texture, NULL, false);
+    Quad::Viewport view { 0, 0, (double)this->width, (double)this->height };
+    this->quad = new Quad { view, (double)this->texture->width, (double)this->texture->height };
+}
+
+bool Texture::Load()
+{
+    FILE* file = std::fopen(this->path.c_str(), "rb");
+
+    if (!file)
+        return false;
+
+    /* the importer reads in small pieces, batch them into fewer file system reads */
+    auto buffer = std::make_unique<char[]>(FILE_BUFFER_SIZE);
+    std::setvbuf(file, buffer.get(), _IOFBF, FILE_BUFFER_SIZE);
+
+    /* streams straight into the texture, without a copy of the whole file */
+    auto* texture           = new C3D_Tex();
+    Tex3DS_Texture imported = Tex3DS_TextureImportStdio(file, texture, NULL, false);
 
     std::fclose(file);
 
     if (!imported)
-        return;
+    {
+        delete texture;
+        return false;
+    }
 
     const Tex3DS_SubTexture* subTexture = Tex3DS_GetSubTexture(imported, 0);
 
     this->width  = subTexture->width;
     this->height = subTexture->height;
 
-    this->valid = true;
-
     Tex3DS_TextureFree(imported);
 
-    this->texture->border = 0;
-    C3D_TexSetFilter(this->texture, GPU_LINEAR, GPU_LINEAR);
-    C3D_TexSetWrap(this->texture, GPU_CLAMP_TO_BORDER, GPU_CLAMP_TO_BORDER);
+    texture->border = 0;
+    C3D_TexSetFilter(texture, GPU_LINEAR, GPU_LINEAR);
+    C3D_TexSetWrap(texture, GPU_CLAMP_TO_BORDER, GPU_CLAMP_TO_BORDER);
 
-    Quad::Viewport view { 0, 0, (double)this->width, (double)this->height };
-    this->quad = new Quad { view, (double)this->texture->width, (double)this->texture->height };
+    this->texture = texture;
+
+    this->format = getPixelFormat(texture->fmt);
+    this->size   = 0;
+
+    if (this->format == PIXELFORMAT_UNKNOWN)
+        this->size = texture->size;
+    else
+    {
+        for (int level = 0; level <= texture->maxLevel; level++)
+        {
+            const int width  = std::max(texture->width >> level, 8);
+            const int height = std::max(texture->height >> level, 8);
+
+            this->size += GetPixelFormatSliceSize(this->format, width, height, false);
+        }
+    }
+
+    return true;
+}
+
+void Texture::Unload()
+{
+    if (!this->texture)
+        return;
+
+    C3D_TexDelete(this->texture);
+    delete this->texture;
+
+    this->texture = nullptr;
+}
+
+C3D_Tex* Texture::GetTexture()
+{
+    if (this->valid && !this->texture && this->cached)
+        TextureCache::Instance().Reload(this);
+
+    return this->texture;
 }
 
 Texture::~Texture()
 {
+    if (this->cached)
+        TextureCache::Instance().Remove(this);
+
+    this->Unload();
+
     if (this->quad)
         delete this->quad;
 }
 
 void Texture::Draw(Graphics& graphics, const Matrix4& matrix)
 {
-    if (!this->valid)
+    if (this->GetTexture() == nullptr)
         return;
 
-    const auto& transform = graphics.GetTransform();
-    bool is2D             = transform.IsAffine2DTransform();
+    this->lastFrame = Renderer::GetFrame();
+
+    auto& renderer = Renderer::Instance();
 
-    Matrix4 translated(transform, matrix);
+    int first      = 0;
+    auto* vertices = renderer.GetFixedColorVertices(4, first);
 
-    DrawCommand command(4);
-    command.handles = { this->texture };
+    if (vertices == nullptr)
+    {
+        LOG("Frame vertex buffer is full, dropping a texture draw");
+        return;
+    }
 
-    if (is2D)
-        translated.TransformXY(command.Positions().get(), this->quad->GetVertices(), command.count);
+    const Affine2D transform = graphics.GetTransform() * Affine2D(matrix);
+
+    transform.TransformPositions(vertices, this->quad->GetVertices(), 4);
 
     const auto* coords = this->quad->GetTextureCoords();
-    command.FillVertices(graphics.GetColor(), coords);
 
-    Renderer::Instance().Render(command);
+    for (size_t index = 0; index < 4; index++)
+        vertices[index].texcoord = { coords[index].x, coords[index].y };
+
+    DrawCommand command(4, first, DrawCommand::TEXENV_MODE_TEXTURE,
+                        vertex::PRIMITIVE_TRIANGLE_FAN);
+    command.handles    = { this->texture };
+    command.fixedColor = graphics.GetColor();
+
+    renderer.Render(command);
 }
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "texturecache.hpp"
+
+#include "logfile.hpp"
+#include "renderer.hpp"
+
+using namespace love;
+
+TextureCache::TextureCache() : textures {}, budget(DEFAULT_BUDGET), resident(0)
+{}
+
+StrongReference<Texture> TextureCache::Get(const std::string& path)
+{
+    const auto iterator = this->textures.find(path);
+
+    if (iterator != this->textures.end())
+        return StrongReference<Texture>(iterator->second);
+
+    StrongReference<Texture> texture(new Texture(path), Acquire::NORETAIN);
+
+    /* failed loads are not kept, so the next Get tries again */
+    if (!texture->IsValid())
+        return texture;
+
+    texture->cached    = true;
+    texture->lastFrame = Renderer::GetFrame();
+
+    this->textures.emplace(path, texture.Get());
+    this->resident += texture->GetSize();
+
+    this->Evict(texture);
+
+    return texture;
+}
+
+void TextureCache::SetBudget(size_t bytes)
+{
+    this->budget = bytes;
+    this->Evict(nullptr);
+}
+
+void TextureCache::Reload(Texture* texture)
+{
+    if (!texture->Load())
+    {
+        LOG("Failed to reload texture '%s'", texture->GetPath().c_str());
+        texture->valid = false;
+
+        return;
+    }
+
+    texture->lastFrame = Renderer::GetFrame();
+    this->resident += texture->GetSize();
+
+    this->Evict(texture);
+}
+
+void TextureCache::Remove(Texture* texture)
+{
+    if (texture->IsResident())
+        this->resident -= texture->GetSize();
+
+    this->textures.erase(texture->GetPath());
+}
+
+void TextureCache::Evict(const Texture* keep)
+{
+    const uint32_t frame = Renderer::GetFrame();
+
+    while (this->resident > this->budget)
+    {
+        Texture* oldest = nullptr;
+
+        for (const auto& [path, texture] : this->textures)
+        {
+            /* the GPU may still read textures drawn this frame */
+            if (texture == keep || !texture->IsResident() || texture->lastFrame >= frame)
+                continue;
+
+            if (oldest == nullptr || texture->lastFrame < oldest->lastFrame)
+                oldest = texture;
+        }
+
+        if (oldest == nullptr)
+        {
+            LOG("Texture budget exceeded (%zu of %zu bytes)", this->resident, this->budget);
+            return;
+        }
+
+        this->resident -= oldest->GetSize();
+        oldest->Unload();
+    }
+}
@@ -0,0 +1,144 @@
+#include "textureloader.hpp"
+
+#include "exception.hpp"
+
+#include <algorithm>
+
+using namespace love;
+
+/* how long Wait sleeps between checks while the worker loads the texture */
+static constexpr int64_t WAIT_INTERVAL_NS = 1000000;
+
+TextureLoader::Request::Request(const std::string& path, Priority priority) :
+    path(path),
+    priority(priority),
+    texture(),
+    state(STATE_PENDING)
+{}
+
+bool TextureLoader::Request::Run()
+{
+    State expected = STATE_PENDING;
+
+    if (!this->state.compare_exchange_strong(expected, STATE_LOADING))
+        return false;
+
+    State result = STATE_FAILED;
+
+    try
+    {
+        this->texture.Set(new Texture(this->path), Acquire::NORETAIN);
+
+        if (this->texture->IsValid())
+            result = STATE_DONE;
+    }
+    catch (...)
+    {}
+
+    /* everything the texture wrote is visible to whoever sees the new state */
+    this->state.store(result, std::memory_order_release);
+
+    return true;
+}
+
+TextureLoader::TextureLoader() : queue(), sequence(0), quit(false), thread(nullptr)
+{
+    LightLock_Init(&this->lock);
+    LightSemaphore_Init(&this->pending, 0, INT16_MAX);
+
+    /* below the render thread, on its core: loads run while it waits for vblank */
+    int32_t priority = 0x30;
+    svcGetThreadPriority(&priority, CUR_THREAD_HANDLE);
+
+    this->thread = threadCreate(TextureLoader::ThreadMain, this, STACK_SIZE,
+                                std::min(priority + 1, 0x3F), -2, false);
+
+    if (this->thread == nullptr)
+        throw love::Exception("Failed to create the texture loader thread.");
+}
+
+TextureLoader::~TextureLoader()
+{
+    this->quit = true;
+    LightSemaphore_Release(&this->pending, 1);
+
+    threadJoin(this->thread, U64_MAX);
+    threadFree(this->thread);
+}
+
+void TextureLoader::ThreadMain(void* loader)
+{
+    ((TextureLoader*)loader)->Run();
+}
+
+void TextureLoader::Lock()
+{
+    LightLock_Lock(&this->lock);
+}
+
+void TextureLoader::Unlock()
+{
+    LightLock_Unlock(&this->lock);
+}
+
+StrongReference<TextureLoader::Request> TextureLoader::Load(const std::string& path,
+                                                            Priority priority)
+{
+    StrongReference<Request> request(new Request(path, priority), Acquire::NORETAIN);
+
+    this->Lock();
+    this->queue.push({ priority, this->sequence++, request });
+    this->Unlock();
+
+    LightSemaphore_Release(&this->pending, 1);
+
+    return request;
+}
+
+Texture* TextureLoader::Wait(Request* request)
+{
+    /* the worker skips it once it gets there */
+    request->Run();
+
+    while (!request->IsFinished())
+    {
+        svcSleepThread(WAIT_INTERVAL_NS);
+    }
+
+    return request->GetTexture();
+}
+
+size_t TextureLoader::GetPendingCount()
+{
+    this->Lock();
+    const size_t count = this->queue.size();
+    this->Unlock();
+
+    return count;
+}
+
+StrongReference<TextureLoader::Request> TextureLoader::Pop()
+{
+    this->Lock();
+
+    StrongReference<Request> request = this->queue.top().request;
+    this->queue.pop();
+
+    this->Unlock();
+
+    return request;
+}
+
+void TextureLoader::Run()
+{
+    while (true)
+    {
+        LightSemaphore_Acquire(&this->pending, 1);
+
+        if (this->quit)
+            break;
+
+        /* canceled requests and ones already loaded by Wait are skipped */
+        this->Pop()->Run();
+    }
+}
@@ -0,0 +1,138 @@
+#include "textwrap.hpp"
+#include "unicode.hpp"
+
+#include <algorithm>
+
+using namespace love;
+
+TextWrap::TextWrap(Font* font, float wraplimit) :
+    font(font),
+    wraplimit(wraplimit),
+    codepoints {},
+    lines {},
+    previous {}
+{
+    this->Rewrap(0, 0, 0);
+}
+
+void TextWrap::Decode(std::string_view text, Font::Codepoints& out)
+{
+    if (unicode::FindInvalid(text) != text.size())
+        throw love::Exception("UTF-8 decoding error: Invalid UTF-8");
+
+    out.resize(text.size());
+    out.resize(unicode::DecodeUnchecked(text, out.data()));
+}
+
+void TextWrap::SetWrapLimit(float wraplimit)
+{
+    if (this->wraplimit == wraplimit)
+        return;
+
+    this->wraplimit = wraplimit;
+
+    this->lines.clear();
+    this->Rewrap(0, 0, 0);
+}
+
+void TextWrap::Set(std::string_view text)
+{
+    TextWrap::Decode(text, this->codepoints);
+
+    this->lines.clear();
+    this->Rewrap(0, 0, 0);
+}
+
+void TextWrap::Clear()
+{
+    this->Set({});
+}
+
+void TextWrap::Append(std::string_view text)
+{
+    this->Replace(this->codepoints.size(), 0, text);
+}
+
+void TextWrap::Erase(size_t start, size_t count)
+{
+    this->Replace(start, count, {});
+}
+
+void TextWrap::Replace(size_t start, size_t count, std::string_view text)
+{
+    start = std::min(start, this->codepoints.size());
+    count = std::min(count, this->codepoints.size() - start);
+
+    Font::Codepoints inserted {};
+    TextWrap::Decode(text, inserted);
+
+    auto first = this->codepoints.begin() + start;
+
+    if (inserted.size() >= count)
+    {
+        std::copy_n(inserted.begin(), count, first);
+        this->codepoints.insert(first + count, inserted.begin() + count, inserted.end());
+    }
+    else
+    {
+        std::copy(inserted.begin(), inserted.end(), first);
+        this->codepoints.erase(first + inserted.size(), first + count);
+    }
+
+    this->Rewrap(start, start + count, start + inserted.size());
+}
+
+/*
+** @start: first changed codepoint
+** @oldEnd: end of the replaced range, before the edit
+** @newEnd: end of the inserted range, after the edit
+*/
+void TextWrap::Rewrap(size_t start, size_t oldEnd, size_t newEnd)
+{
+    const auto byStart = [](const Font::WrapLine& line, int value) { return line.start < value; };
+    const auto byLast  = [](const Font::WrapLine& line, int value) { return line.last < value; };
+
+    /*
+    ** restart at the first line that read the edited codepoints; a break without
+    ** spaces can look ahead across several following lines
+    */
+    auto first = std::lower_bound(this->lines.begin(), this->lines.end(), (int)start, byLast);
+
+    if (first == this->lines.end())
+        first = this->lines.begin();
+
+    this->previous.assign(first, this->lines.end());
+    this->lines.erase(first, this->lines.end());
+
+    const int delta = (int)newEnd - (int)oldEnd;
+    int next        = this->previous.empty() ? 0 : this->previous.front().start;
+
+    Font::WrapLine line {};
+
+    do
+    {
+        next = this->font->GetWrapLine(this->codepoints, next, this->wraplimit, line);
+        this->lines.push_back(line);
+
+        if (next < (int)newEnd)
+            continue;
+
+        /* past the edit: once a line starts where an old one did, the rest is unchanged */
+        auto match = std::lower_bound(this->previous.begin(), this->previous.end(), next - delta,
+                                      byStart);
+
+        if (match != this->previous.end() && match->start == next - delta &&
+            match->start >= (int)oldEnd)
+        {
+            for (; match != this->previous.end(); ++match)
+            {
+                this->lines.push_back({ match->start + delta, match->count, match->width,
+                                        match->last + delta });
+            }
+
+            break;
+        }
+    } while (next >= 0);
+
+    this->previous.clear();
+}
@@ -0,0 +1,830 @@
+#include "triangulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace love;
+
+Triangulator::Triangulator() :
+    nodes {},
+    indices {},
+    minX(0.0f),
+    minY(0.0f),
+    invSize(0.0f),
+    cache {},
+    uses(0)
+{}
+
+/* FNV-1a over the raw point data */
+uint64_t Triangulator::Hash(std::span<const Vector2> points)
+{
+    const auto* bytes = (const uint8_t*)points.data();
+    uint64_t hash     = 0xCBF29CE484222325;
+
+    for (size_t index = 0; index < points.size_bytes(); index++)
+        hash = (hash ^ bytes[index]) * 0x100000001B3;
+
+    return hash;
+}
+
+/*
+** Convex when every turn goes the same way and the edges sweep around only
+** once, which rules out self-intersecting stars with all turns alike.
+*/
+bool Triangulator::IsConvex(std::span<const Vector2> points)
+{
+    const size_t count = points.size();
+
+    if (count < 3)
+        return false;
+
+    int winding = 0;
+    int xFlips  = 0;
+    int yFlips  = 0;
+
+    Vector2 edge = points[0] - points[count - 1];
+    float lastDX = edge.x;
+    float lastDY = edge.y;
+
+    for (size_t index = 0; index < count; index++)
+    {
+        const Vector2& current = points[index];
+        const Vector2& next    = points[(index + 1) % count];
+
+        const Vector2 nextEdge = next - current;
+        const float cross      = Vector2::cross(edge, nextEdge);
+
+        if (cross != 0.0f)
+        {
+            const int sign = cross > 0.0f ? 1 : -1;
+
+            if (winding != 0 && sign != winding)
+                return false;
+
+            winding = sign;
+        }
+
+        if (nextEdge.x != 0.0f)
+        {
+            if (lastDX != 0.0f && (nextEdge.x > 0.0f) != (lastDX > 0.0f))
+                xFlips++;
+
+            lastDX = nextEdge.x;
+        }
+
+        if (nextEdge.y != 0.0f)
+        {
+            if (lastDY != 0.0f && (nextEdge.y > 0.0f) != (lastDY > 0.0f))
+                yFlips++;
+
+            lastDY = nextEdge.y;
+        }
+
+        if (nextEdge.x != 0.0f || nextEdge.y != 0.0f)
+            edge = nextEdge;
+    }
+
+    return winding != 0 && xFlips <= 2 && yFlips <= 2;
+}
+
+std::span<const uint16_t> Triangulator::Triangulate(std::span<const Vector2> points)
+{
+    this->indices.clear();
+
+    const size_t count = points.size();
+
+    if (count < 3 || count > (size_t)UINT16_MAX + 1)
+        return {};
+
+    if (Triangulator::IsConvex(points))
+    {
+        this->Fan(count);
+        return this->indices;
+    }
+
+    const uint64_t key = Triangulator::Hash(points);
+    this->uses++;
+
+    auto iterator = this->cache.find(key);
+
+    if (iterator != this->cache.end())
+    {
+        auto& entry = iterator->second;
+
+        if (entry.points.size() == count &&
+            std::memcmp(entry.points.data(), points.data(), points.size_bytes()) == 0)
+        {
+            entry.lastUse = this->uses;
+            return entry.indices;
+        }
+    }
+
+    this->EarClip(points);
+
+    if (this->cache.size() >= Triangulator::MAX_CACHE_ENTRIES && iterator == this->cache.end())
+    {
+        const auto oldest = std::min_element(this->cache.begin(), this->cache.end(),
+                                             [](const auto& a, const auto& b) {
+                                                 return a.second.lastUse < b.second.lastUse;
+                                             });
+
+        this->cache.erase(oldest);
+    }
+
+    auto& entry = this->cache[key];
+
+    entry.points.assign(points.begin(), points.end());
+    entry.indices = this->indices;
+    entry.lastUse = this->uses;
+
+    return this->indices;
+}
+
+void Triangulator::Fan(size_t count)
+{
+    this->indices.reserve((count - 2) * 3);
+
+    for (size_t index = 1; index + 1 < count; index++)
+    {
+        this->indices.push_back(0);
+        this->indices.push_back((uint16_t)index);
+        this->indices.push_back((uint16_t)(index + 1));
+    }
+}
+
+void Triangulator::EarClip(std::span<const Vector2> points)
+{
+    this->nodes.clear();
+    this->nodes.reserve(points.size() * 3 / 2);
+
+    this->indices.reserve((points.size() - 2) * 3);
+
+    const int outer = this->LinkedList(points);
+
+    if (outer < 0 || this->nodes[outer].next == this->nodes[outer].prev)
+        return;
+
+    this->invSize = 0.0f;
+
+    if (points.size() > Triangulator::HASH_THRESHOLD)
+    {
+        float maxX = points[0].x;
+        float maxY = points[0].y;
+
+        this->minX = maxX;
+        this->minY = maxY;
+
+        for (const auto& point : points)
+        {
+            this->minX = std::min(this->minX, point.x);
+            this->minY = std::min(this->minY, point.y);
+            maxX       = std::max(maxX, point.x);
+            maxY       = std::max(maxY, point.y);
+        }
+
+        const float size = std::max(maxX - this->minX, maxY - this->minY);
+        this->invSize    = size != 0.0f ? 32767.0f / size : 0.0f;
+    }
+
+    this->EarcutLinked(outer, 0);
+}
+
+/* links the points so that the polygon winds the way EarcutLinked expects */
+int Triangulator::LinkedList(std::span<const Vector2> points)
+{
+    float sum = 0.0f;
+
+    for (size_t index = 0, previous = points.size() - 1; index < points.size(); index++)
+    {
+        sum += (points[previous].x - points[index].x) * (points[index].y + points[previous].y);
+        previous = index;
+    }
+
+    int last = -1;
+
+    if (sum > 0.0f)
+    {
+        for (size_t index = 0; index < points.size(); index++)
+            last = this->InsertNode(index, points[index], last);
+    }
+    else
+    {
+        for (size_t index = points.size(); index-- > 0;)
+            last = this->InsertNode(index, points[index], last);
+    }
+
+    if (last >= 0 && this->Equals(last, this->nodes[last].next))
+    {
+        const int next = this->nodes[last].next;
+        this->RemoveNode(last);
+        last = next;
+    }
+
+    return last;
+}
+
+int Triangulator::InsertNode(int index, const Vector2& point, int last)
+{
+    const int node = (int)this->nodes.size();
+    this->nodes.push_back({ point.x, point.y, 0, index, node, node, -1, -1, false });
+
+    if (last >= 0)
+    {
+        auto& current = this->nodes[node];
+
+        current.next = this->nodes[last].next;
+        current.prev = last;
+
+        this->nodes[this->nodes[last].next].prev = node;
+        this->nodes[last].next                   = node;
+    }
+
+    return node;
+}
+
+void Triangulator::RemoveNode(int node)
+{
+    const auto& current = this->nodes[node];
+
+    this->nodes[current.next].prev = current.prev;
+    this->nodes[current.prev].next = current.next;
+
+    if (current.prevZ >= 0)
+        this->nodes[current.prevZ].nextZ = current.nextZ;
+
+    if (current.nextZ >= 0)
+        this->nodes[current.nextZ].prevZ = current.prevZ;
+}
+
+/* drops duplicate and collinear points */
+int Triangulator::FilterPoints(int start, int end)
+{
+    if (start < 0)
+        return start;
+
+    if (end < 0)
+        end = start;
+
+    int node   = start;
+    bool again = false;
+
+    do
+    {
+        again = false;
+
+        const auto& current = this->nodes[node];
+
+        if (this->Equals(node, current.next) || this->Area(current.prev, node, current.next) == 0)
+        {
+            const int previous = current.prev;
+            this->RemoveNode(node);
+            node = end = previous;
+
+            if (node == this->nodes[node].next)
+                break;
+
+            again = true;
+        }
+        else
+            node = current.next;
+    } while (again || node != end);
+
+    return end;
+}
+
+/*
+** Clips ears until the polygon is gone. When no ear is left, it retries with
+** duplicate points removed, then with small self-intersections cut off, and
+** finally by splitting the polygon along a valid diagonal.
+*/
+void Triangulator::EarcutLinked(int ear, int pass)
+{
+    if (ear < 0)
+        return;
+
+    if (pass == 0 && this->invSize != 0.0f)
+        this->IndexCurve(ear);
+
+    /*
+    ** Clipping only ever turns reflex vertices convex. Once none are left,
+    ** every vertex is an ear and the rest of the polygon is a fan, which
+    ** saves testing the long ears that close off a round polygon.
+    */
+    int reflexCount = 0;
+
+    if (pass == 0)
+        reflexCount = this->CountReflex(ear);
+
+    int stop = ear;
+
+    while (this->nodes[ear].prev != this->nodes[ear].next)
+    {
+        const int previous = this->nodes[ear].prev;
+        const int next     = this->nodes[ear].next;
+
+        if (pass == 0 && reflexCount == 0)
+        {
+            this->FanLinked(ear);
+            break;
+        }
+
+        if (this->invSize != 0.0f ? this->IsEarHashed(ear) : this->IsEar(ear))
+        {
+            this->indices.push_back(this->nodes[previous].index);
+            this->indices.push_back(this->nodes[ear].index);
+            this->indices.push_back(this->nodes[next].index);
+
+            this->RemoveNode(ear);
+
+            if (pass == 0)
+                reflexCount -= this->UpdateReflex(previous) + this->UpdateReflex(next);
+
+            ear = stop = this->nodes[next].next;
+            continue;
+        }
+
+        ear = next;
+
+        if (ear == stop)
+        {
+            if (pass == 0)
+                this->EarcutLinked(this->FilterPoints(ear), 1);
+            else if (pass == 1)
+            {
+                ear = this->CureLocalIntersections(this->FilterPoints(ear));
+                this->EarcutLinked(ear, 2);
+            }
+            else if (pass == 2)
+                this->SplitEarcut(ear);
+
+            break;
+        }
+    }
+}
+
+/* flags every reflex (or flat) vertex of the ring and returns how many there are */
+int Triangulator::CountReflex(int start)
+{
+    int count = 0;
+    int node  = start;
+
+    do
+    {
+        auto& current  = this->nodes[node];
+        current.reflex = this->Area(current.prev, node, current.next) >= 0;
+
+        count += current.reflex;
+        node = current.next;
+    } while (node != start);
+
+    return count;
+}
+
+/* returns 1 if @node stopped being reflex */
+int Triangulator::UpdateReflex(int node)
+{
+    auto& current = this->nodes[node];
+
+    if (!current.reflex || this->Area(current.prev, node, current.next) >= 0)
+        return 0;
+
+    current.reflex = false;
+    return 1;
+}
+
+void Triangulator::FanLinked(int start)
+{
+    const int first = this->nodes[start].index;
+
+    for (int node = this->nodes[start].next; this->nodes[node].next != start;)
+    {
+        const int next = this->nodes[node].next;
+
+        this->indices.push_back(first);
+        this->indices.push_back(this->nodes[node].index);
+        this->indices.push_back(this->nodes[next].index);
+
+        node = next;
+    }
+}
+
+static bool pointInTriangle(float ax, float ay, float bx, float by, float cx, float cy, float px,
+                            float py)
+{
+    return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+           (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+           (bx - px) * (cy - py) >= (cx - px) * (by - py);
+}
+
+/* an ear is convex and holds no other point of the polygon */
+bool Triangulator::IsEar(int ear) const
+{
+    const auto& a = this->nodes[this->nodes[ear].prev];
+    const auto& b = this->nodes[ear];
+    const auto& c = this->nodes[b.next];
+
+    if (this->Area(b.prev, ear, b.next) >= 0)
+        return false;
+
+    const float x0 = std::min({ a.x, b.x, c.x });
+    const float y0 = std::min({ a.y, b.y, c.y });
+    const float x1 = std::max({ a.x, b.x, c.x });
+    const float y1 = std::max({ a.y, b.y, c.y });
+
+    for (int node = c.next; node != b.prev; node = this->nodes[node].next)
+    {
+        const auto& p = this->nodes[node];
+
+        if (p.x >= x0 && p.x <= x1 && p.y >= y0 && p.y <= y1 &&
+            pointInTriangle(a.x, a.y, b.x, b.y, c.x, c.y, p.x, p.y) &&
+            this->Area(p.prev, node, p.next) >= 0)
+            return false;
+    }
+
+    return true;
+}
+
+/* same as IsEar, but only visits the points whose z-order falls inside the ear's bounds */
+bool Triangulator::IsEarHashed(int ear) const
+{
+    const int first = this->nodes[ear].prev;
+    const int last  = this->nodes[ear].next;
+
+    const auto& a = this->nodes[first];
+    const auto& b = this->nodes[ear];
+    const auto& c = this->nodes[last];
+
+    if (this->Area(first, ear, last) >= 0)
+        return false;
+
+    const float x0 = std::min({ a.x, b.x, c.x });
+    const float y0 = std::min({ a.y, b.y, c.y });
+    const float x1 = std::max({ a.x, b.x, c.x });
+    const float y1 = std::max({ a.y, b.y, c.y });
+
+    const uint32_t minZ = this->ZOrder(x0, y0);
+    const uint32_t maxZ = this->ZOrder(x1, y1);
+
+    const auto blocks = [&](int node) {
+        const auto& p = this->nodes[node];
+
+        return node != first && node != last && p.x >= x0 && p.x <= x1 && p.y >= y0 &&
+               p.y <= y1 && pointInTriangle(a.x, a.y, b.x, b.y, c.x, c.y, p.x, p.y) &&
+               this->Area(p.prev, node, p.next) >= 0;
+    };
+
+    int down = b.prevZ;
+    int up   = b.nextZ;
+
+    /* look both ways along the curve at once, then finish whichever is left */
+    while (down >= 0 && this->nodes[down].z >= minZ && up >= 0 && this->nodes[up].z <= maxZ)
+    {
+        if (blocks(down) || blocks(up))
+            return false;
+
+        down = this->nodes[down].prevZ;
+        up   = this->nodes[up].nextZ;
+    }
+
+    for (; down >= 0 && this->nodes[down].z >= minZ; down = this->nodes[down].prevZ)
+    {
+        if (blocks(down))
+            return false;
+    }
+
+    for (; up >= 0 && this->nodes[up].z <= maxZ; up = this->nodes[up].nextZ)
+    {
+        if (blocks(up))
+            return false;
+    }
+
+    return true;
+}
+
+/* cuts off the triangle at every place where two neighbouring edges cross */
+int Triangulator::CureLocalIntersections(int start)
+{
+    int node = start;
+
+    do
+    {
+        const int a = this->nodes[node].prev;
+        const int b = this->nodes[this->nodes[node].next].next;
+
+        if (!this->Equals(a, b) && this->Intersects(a, node, this->nodes[node].next, b) &&
+            this->LocallyInside(a, b) && this->LocallyInside(b, a))
+        {
+            this->indices.push_back(this->nodes[a].index);
+            this->indices.push_back(this->nodes[node].index);
+            this->indices.push_back(this->nodes[b].index);
+
+            this->RemoveNode(this->nodes[node].next);
+            this->RemoveNode(node);
+
+            node = start = b;
+        }
+
+        node = this->nodes[node].next;
+    } while (node != start);
+
+    return this->FilterPoints(node);
+}
+
+/* splits the polygon in two along a diagonal and clips both halves */
+void Triangulator::SplitEarcut(int start)
+{
+    int a = start;
+
+    do
+    {
+        int b = this->nodes[this->nodes[a].next].next;
+
+        while (b != this->nodes[a].prev)
+        {
+            if (this->nodes[a].index != this->nodes[b].index && this->IsValidDiagonal(a, b))
+            {
+                int c = this->SplitPolygon(a, b);
+
+                a = this->FilterPoints(a, this->nodes[a].next);
+                c = this->FilterPoints(c, this->nodes[c].next);
+
+                this->EarcutLinked(a, 0);
+                this->EarcutLinked(c, 0);
+
+                return;
+            }
+
+            b = this->nodes[b].next;
+        }
+
+        a = this->nodes[a].next;
+    } while (a != start);
+}
+
+/* links a to b, and copies of both to close the other half; returns b's copy */
+int Triangulator::SplitPolygon(int a, int b)
+{
+    const Vector2 pointA(this->nodes[a].x, this->nodes[a].y);
+    const Vector2 pointB(this->nodes[b].x, this->nodes[b].y);
+
+    const int a2 = this->InsertNode(this->nodes[a].index, pointA, -1);
+    const int b2 = this->InsertNode(this->nodes[b].index, pointB, -1);
+
+    const int an = this->nodes[a].next;
+    const int bp = this->nodes[b].prev;
+
+    this->nodes[a].next = b;
+    this->nodes[b].prev = a;
+
+    this->nodes[a2].next = an;
+    this->nodes[an].prev = a2;
+
+    this->nodes[b2].next = a2;
+    this->nodes[a2].prev = b2;
+
+    this->nodes[bp].next = b2;
+    this->nodes[b2].prev = bp;
+
+    return b2;
+}
+
+bool Triangulator::IsValidDiagonal(int a, int b) const
+{
+    const auto& nodeA = this->nodes[a];
+    const auto& nodeB = this->nodes[b];
+
+    if (this->nodes[nodeA.next].index == nodeB.index ||
+        this->nodes[nodeA.prev].index == nodeB.index || this->IntersectsPolygon(a, b))
+        return false;
+
+    if (this->LocallyInside(a, b) && this->LocallyInside(b, a) && this->MiddleInside(a, b) &&
+        (this->Area(nodeA.prev, a, nodeB.prev) != 0 || this->Area(a, nodeB.prev, b) != 0))
+        return true;
+
+    return this->Equals(a, b) && this->Area(nodeA.prev, a, nodeA.next) > 0 &&
+           this->Area(nodeB.prev, b, nodeB.next) > 0;
+}
+
+bool Triangulator::IntersectsPolygon(int a, int b) const
+{
+    const int indexA = this->nodes[a].index;
+    const int indexB = this->nodes[b].index;
+
+    int node = a;
+
+    do
+    {
+        const int next = this->nodes[node].next;
+
+        const int index     = this->nodes[node].index;
+        const int nextIndex = this->nodes[next].index;
+
+        if (index != indexA && nextIndex != indexA && index != indexB && nextIndex != indexB &&
+            this->Intersects(node, next, a, b))
+            return true;
+
+        node = next;
+    } while (node != a);
+
+    return false;
+}
+
+bool Triangulator::LocallyInside(int a, int b) const
+{
+    const auto& node = this->nodes[a];
+
+    if (this->Area(node.prev, a, node.next) < 0)
+        return this->Area(a, b, node.next) >= 0 && this->Area(a, node.prev, b) >= 0;
+
+    return this->Area(a, b, node.prev) < 0 || this->Area(a, node.next, b) < 0;
+}
+
+bool Triangulator::MiddleInside(int a, int b) const
+{
+    const float px = (this->nodes[a].x + this->nodes[b].x) / 2;
+    const float py = (this->nodes[a].y + this->nodes[b].y) / 2;
+
+    bool inside = false;
+    int node    = a;
+
+    do
+    {
+        const auto& p = this->nodes[node];
+        const auto& n = this->nodes[p.next];
+
+        if (((p.y > py) != (n.y > py)) && n.y != p.y &&
+            (px < (n.x - p.x) * (py - p.y) / (n.y - p.y) + p.x))
+            inside = !inside;
+
+        node = p.next;
+    } while (node != a);
+
+    return inside;
+}
+
+float Triangulator::Area(int p, int q, int r) const
+{
+    const auto& a = this->nodes[p];
+    const auto& b = this->nodes[q];
+    const auto& c = this->nodes[r];
+
+    return (b.y - a.y) * (c.x - b.x) - (b.x - a.x) * (c.y - b.y);
+}
+
+bool Triangulator::Equals(int a, int b) const
+{
+    return this->nodes[a].x == this->nodes[b].x && this->nodes[a].y == this->nodes[b].y;
+}
+
+static int sign(float value)
+{
+    return (value > 0) - (value < 0);
+}
+
+/* whether q lies within the bounds of the collinear segment pr */
+static bool onSegment(float px, float py, float qx, float qy, float rx, float ry)
+{
+    return qx <= std::max(px, rx) && qx >= std::min(px, rx) && qy <= std::max(py, ry) &&
+           qy >= std::min(py, ry);
+}
+
+bool Triangulator::Intersects(int p1, int q1, int p2, int q2) const
+{
+    const int o1 = sign(this->Area(p1, q1, p2));
+    const int o2 = sign(this->Area(p1, q1, q2));
+    const int o3 = sign(this->Area(p2, q2, p1));
+    const int o4 = sign(this->Area(p2, q2, q1));
+
+    if (o1 != o2 && o3 != o4)
+        return true;
+
+    const auto& a = this->nodes[p1];
+    const auto& b = this->nodes[q1];
+    const auto& c = this->nodes[p2];
+    const auto& d = this->nodes[q2];
+
+    if (o1 == 0 && onSegment(a.x, a.y, c.x, c.y, b.x, b.y))
+        return true;
+
+    if (o2 == 0 && onSegment(a.x, a.y, d.x, d.y, b.x, b.y))
+        return true;
+
+    if (o3 == 0 && onSegment(c.x, c.y, a.x, a.y, d.x, d.y))
+        return true;
+
+    if (o4 == 0 && onSegment(c.x, c.y, b.x, b.y, d.x, d.y))
+        return true;
+
+    return false;
+}
+
+/* interleaves the bits of x and y, scaled to 15 bits each */
+uint32_t Triangulator::ZOrder(float x, float y) const
+{
+    uint32_t zx = (uint32_t)((x - this->minX) * this->invSize);
+    uint32_t zy = (uint32_t)((y - this->minY) * this->invSize);
+
+    zx = (zx | (zx << 8)) & 0x00FF00FF;
+    zx = (zx | (zx << 4)) & 0x0F0F0F0F;
+    zx = (zx | (zx << 2)) & 0x33333333;
+    zx = (zx | (zx << 1)) & 0x55555555;
+
+    zy = (zy | (zy << 8)) & 0x00FF00FF;
+    zy = (zy | (zy << 4)) & 0x0F0F0F0F;
+    zy = (zy | (zy << 2)) & 0x33333333;
+    zy = (zy | (zy << 1)) & 0x55555555;
+
+    return zx | (zy << 1);
+}
+
+void Triangulator::IndexCurve(int start)
+{
+    int node = start;
+
+    do
+    {
+        auto& current = this->nodes[node];
+
+        if (current.z == 0)
+            current.z = this->ZOrder(current.x, current.y);
+
+        current.prevZ = current.prev;
+        current.nextZ = current.next;
+
+        node = current.next;
+    } while (node != start);
+
+    this->nodes[this->nodes[node].prevZ].nextZ = -1;
+    this->nodes[node].prevZ                    = -1;
+
+    this->SortLinked(node);
+}
+
+/* bottom-up merge sort of the z list, by z-order */
+int Triangulator::SortLinked(int list)
+{
+    int inSize = 1;
+    int merges = 0;
+
+    do
+    {
+        int p    = list;
+        int tail = -1;
+
+        list   = -1;
+        merges = 0;
+
+        while (p >= 0)
+        {
+            merges++;
+
+            int q     = p;
+            int pSize = 0;
+
+            for (int index = 0; index < inSize; index++)
+            {
+                pSize++;
+                q = this->nodes[q].nextZ;
+
+                if (q < 0)
+                    break;
+            }
+
+            int qSize = inSize;
+
+            while (pSize > 0 || (qSize > 0 && q >= 0))
+            {
+                int node = -1;
+
+                if (pSize != 0 && (qSize == 0 || q < 0 || this->nodes[p].z <= this->nodes[q].z))
+                {
+                    node = p;
+                    p    = this->nodes[p].nextZ;
+                    pSize--;
+                }
+                else
+                {
+                    node = q;
+                    q    = this->nodes[q].nextZ;
+                    qSize--;
+                }
+
+                if (tail >= 0)
+                    this->nodes[tail].nextZ = node;
+                else
+                    list = node;
+
+                this->nodes[node].prevZ = tail;
+                tail                    = node;
+            }
+
+            p = q;
+        }
+
+        this->nodes[tail].nextZ = -1;
+        inSize *= 2;
+    } while (merges > 1);
+
+    return list;
+}
@@ -0,0 +1,81 @@
+#include "unicode.hpp"
+
+#include <utf8.h>
+
+#include <cstring>
+
+using namespace love;
+
+/*
+** Native word size: 4 bytes on the ARM11, 8 on a 64-bit host.
+** Only integer ops are used, so this stays clear of the VFP.
+*/
+using Word = uintptr_t;
+
+static constexpr size_t WORD_SIZE       = sizeof(Word);
+static constexpr Word NON_ASCII_MASK    = (Word)0x8080808080808080ULL;
+static constexpr uint8_t NON_ASCII_BYTE = 0x80;
+
+static inline bool isAsciiWord(const char* text)
+{
+    Word word;
+    std::memcpy(&word, text, WORD_SIZE);
+
+    return (word & NON_ASCII_MASK) == 0;
+}
+
+size_t unicode::FindInvalid(std::string_view text)
+{
+    const char* start = text.data();
+    const char* end   = start + text.size();
+    const char* it    = start;
+
+    while (it != end)
+    {
+        if (size_t(end - it) >= WORD_SIZE && isAsciiWord(it))
+        {
+            it += WORD_SIZE;
+            continue;
+        }
+
+        if (((uint8_t)*it & NON_ASCII_BYTE) == 0)
+        {
+            it++;
+            continue;
+        }
+
+        if (utf8::internal::validate_next(it, end) != utf8::internal::UTF8_OK)
+            return size_t(it - start);
+    }
+
+    return text.size();
+}
+
+size_t unicode::DecodeUnchecked(std::string_view text, uint32_t* out)
+{
+    const char* it  = text.data();
+    const char* end = it + text.size();
+
+    uint32_t* first = out;
+
+    while (it != end)
+    {
+        if (size_t(end - it) >= WORD_SIZE && isAsciiWord(it))
+        {
+            for (size_t index = 0; index < WORD_SIZE; index++)
+                out[index] = (uint8_t)it[index];
+
+            it += WORD_SIZE;
+            out += WORD_SIZE;
+
+            continue;
+        }
+
+        if (((uint8_t)*it & NON_ASCII_BYTE) == 0)
+            *out++ = (uint8_t)*it++;
+        else
+            *out++ = utf8::unchecked::next(it);
+    }
+
+    return size_t(out - first);
+}
@@ -0,0 +1,289 @@
+/*
+** bcfnt2sdf: converts the glyph sheets of a BCFNT into signed distance fields.
+**
+** The output is still a BCFNT with the same cell layout, widths and CMAP, so it
+** loads like any other font. Sheets become A8, where 0.5 is the glyph edge,
+** and FINF fontType is set to Rasterizer::FONT_TYPE_DISTANCE_FIELD so the
+** runtime draws it with TEXENV_MODE_DISTANCE_FIELD.
+**
+** usage: bcfnt2sdf <input.bcfnt> <output.bcfnt> [spread]
+*/
+
+#include "color.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace love;
+
+/* keep in sync with Rasterizer::FONT_TYPE_DISTANCE_FIELD */
+static constexpr uint8_t FONT_TYPE_DISTANCE_FIELD = 0x44;
+
+/* GPU_TEXCOLOR values */
+static constexpr uint16_t FORMAT_A8  = 0x08;
+static constexpr uint16_t FORMAT_LA4 = 0x09;
+static constexpr uint16_t FORMAT_L4  = 0x0A;
+static constexpr uint16_t FORMAT_A4  = 0x0B;
+
+static constexpr int DEFAULT_SPREAD = 4;
+
+/* BCFNT offsets, relative to the start of the file */
+static constexpr size_t CFNT_FILE_SIZE   = 0x0C;
+static constexpr size_t CFNT_HEADER_SIZE = 0x06;
+
+static constexpr size_t FINF_FONT_TYPE = 0x08;
+static constexpr size_t FINF_TGLP      = 0x10;
+static constexpr size_t FINF_CWDH      = 0x14;
+static constexpr size_t FINF_CMAP      = 0x18;
+
+/* relative to the data of a section, which is what FINF and next pointers point to */
+static constexpr size_t SECTION_SIZE = 0x04; //< before the data
+
+static constexpr size_t TGLP_SHEET_SIZE   = 0x04;
+static constexpr size_t TGLP_SHEET_COUNT  = 0x08;
+static constexpr size_t TGLP_SHEET_FORMAT = 0x0A;
+static constexpr size_t TGLP_SHEET_WIDTH  = 0x10;
+static constexpr size_t TGLP_SHEET_HEIGHT = 0x12;
+static constexpr size_t TGLP_SHEET_DATA   = 0x14;
+
+static constexpr size_t CWDH_NEXT = 0x04;
+static constexpr size_t CMAP_NEXT = 0x08;
+
+template<typename T>
+static T read(const std::vector<uint8_t>& data, size_t offset)
+{
+    if (offset + sizeof(T) > data.size())
+        throw love::Exception("Truncated BCFNT at offset 0x%zX.", offset);
+
+    T value {};
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+
+    return value;
+}
+
+template<typename T>
+static void write(std::vector<uint8_t>& data, size_t offset, T value)
+{
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+static std::vector<uint8_t> readFile(const char* path)
+{
+    std::FILE* file = std::fopen(path, "rb");
+
+    if (!file)
+        throw love::Exception("File '%s' does not exist.", path);
+
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::rewind(file);
+
+    std::vector<uint8_t> data(size > 0 ? size : 0);
+    size_t read = std::fread(data.data(), 1, data.size(), file);
+    std::fclose(file);
+
+    if (read != data.size())
+        throw love::Exception("Failed to read '%s'.", path);
+
+    return data;
+}
+
+static void writeFile(const char* path, const std::vector<uint8_t>& data)
+{
+    std::FILE* file = std::fopen(path, "wb");
+
+    if (!file)
+        throw love::Exception("Failed to open '%s' for writing.", path);
+
+    bool success = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    success      = (std::fclose(file) == 0) && success;
+
+    if (!success)
+        throw love::Exception("Failed to write '%s'.", path);
+}
+
+/* coverage of every texel of one tiled sheet, in image order */
+static std::vector<float> readCoverage(const uint8_t* sheet, int width, int height, int format)
+{
+    std::vector<float> coverage(width * height);
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            const unsigned index = Color::TileIndex(width, Vector2(x, y));
+            float value          = 0.0f;
+
+            switch (format)
+            {
+                case FORMAT_A4:
+                case FORMAT_L4:
+                    value = ((sheet[index / 2] >> ((index & 1) * 4)) & 0x0F) / 15.0f;
+                    break;
+                case FORMAT_LA4:
+                    value = (sheet[index] & 0x0F) / 15.0f;
+                    break;
+                case FORMAT_A8:
+                    value = sheet[index] / 255.0f;
+                    break;
+            }
+
+            coverage[y * width + x] = value;
+        }
+    }
+
+    return coverage;
+}
+
+/*
+** Distance to the nearest texel on the other side of the edge, within @spread.
+** Inside is positive; the result is mapped so the edge lands on 0.5.
+*/
+static void writeDistanceField(const std::vector<float>& coverage, int width, int height,
+                               int spread, uint8_t* sheet)
+{
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            const bool inside = coverage[y * width + x] >= 0.5f;
+            float nearest     = (float)spread;
+
+            for (int dy = -spread; dy <= spread; dy++)
+            {
+                for (int dx = -spread; dx <= spread; dx++)
+                {
+                    const int sx = x + dx;
+                    const int sy = y + dy;
+
+                    /* outside the sheet counts as empty */
+                    bool other = inside;
+
+                    if (sx >= 0 && sy >= 0 && sx < width && sy < height)
+                        other = (coverage[sy * width + sx] >= 0.5f) != inside;
+
+                    if (other)
+                        nearest = std::min(nearest, std::sqrt((float)(dx * dx + dy * dy)));
+                }
+            }
+
+            /* the edge lies halfway between two texels */
+            const float distance = inside ? nearest - 0.5f : 0.5f - nearest;
+            const float value    = std::clamp(0.5f + distance / (2.0f * spread), 0.0f, 1.0f);
+
+            const unsigned index = Color::TileIndex(width, Vector2(x, y));
+            sheet[index]         = (uint8_t)std::lround(value * 255.0f);
+        }
+    }
+}
+
+static std::vector<uint8_t> convert(const std::vector<uint8_t>& input, int spread)
+{
+    if (read<uint32_t>(input, 0) != 0x544E4643) //< "CFNT"
+        throw love::Exception("Not a BCFNT file.");
+
+    const size_t finf = read<uint16_t>(input, CFNT_HEADER_SIZE);
+
+    if (read<uint8_t>(input, finf + FINF_FONT_TYPE) == FONT_TYPE_DISTANCE_FIELD)
+        throw love::Exception("Font is already a distance field.");
+
+    const size_t tglp = read<uint32_t>(input, finf + FINF_TGLP);
+
+    const uint32_t sheetSize = read<uint32_t>(input, tglp + TGLP_SHEET_SIZE);
+    const uint16_t count     = read<uint16_t>(input, tglp + TGLP_SHEET_COUNT);
+    const uint16_t format    = read<uint16_t>(input, tglp + TGLP_SHEET_FORMAT);
+    const uint16_t width     = read<uint16_t>(input, tglp + TGLP_SHEET_WIDTH);
+    const uint16_t height    = read<uint16_t>(input, tglp + TGLP_SHEET_HEIGHT);
+    const size_t sheets      = read<uint32_t>(input, tglp + TGLP_SHEET_DATA);
+
+    if (format != FORMAT_A4 && format != FORMAT_L4 && format != FORMAT_LA4 && format != FORMAT_A8)
+        throw love::Exception("Unsupported sheet format 0x%X.", format);
+
+    const size_t oldSize  = (size_t)sheetSize * count;
+    const size_t newSheet = (size_t)width * height;
+    const size_t newSize  = newSheet * count;
+
+    if (sheets + oldSize > input.size())
+        throw love::Exception("Truncated sheet data.");
+
+    /* sheets grow to A8 in place, everything after them moves along */
+    std::vector<uint8_t> output(input.begin(), input.begin() + sheets);
+    output.resize(sheets + newSize);
+    output.insert(output.end(), input.begin() + sheets + oldSize, input.end());
+
+    const long delta = (long)newSize - (long)oldSize;
+
+    const auto relocate = [&](size_t offset) {
+        const uint32_t pointer = read<uint32_t>(output, offset);
+
+        if (pointer > sheets)
+            write<uint32_t>(output, offset, pointer + delta);
+    };
+
+    for (size_t cwdh = read<uint32_t>(input, finf + FINF_CWDH); cwdh != 0;)
+    {
+        const size_t next = read<uint32_t>(input, cwdh + CWDH_NEXT);
+        relocate(cwdh > sheets ? cwdh + delta + CWDH_NEXT : cwdh + CWDH_NEXT);
+        cwdh = next;
+    }
+
+    for (size_t cmap = read<uint32_t>(input, finf + FINF_CMAP); cmap != 0;)
+    {
+        const size_t next = read<uint32_t>(input, cmap + CMAP_NEXT);
+        relocate(cmap > sheets ? cmap + delta + CMAP_NEXT : cmap + CMAP_NEXT);
+        cmap = next;
+    }
+
+    relocate(finf + FINF_CWDH);
+    relocate(finf + FINF_CMAP);
+
+    const size_t tglpSize = tglp - SECTION_SIZE;
+    write<uint32_t>(output, tglpSize, read<uint32_t>(output, tglpSize) + delta);
+
+    write<uint32_t>(output, CFNT_FILE_SIZE, (uint32_t)output.size());
+    write<uint8_t>(output, finf + FINF_FONT_TYPE, FONT_TYPE_DISTANCE_FIELD);
+
+    write<uint32_t>(output, tglp + TGLP_SHEET_SIZE, (uint32_t)newSheet);
+    write<uint16_t>(output, tglp + TGLP_SHEET_FORMAT, FORMAT_A8);
+
+    for (size_t index = 0; index < count; index++)
+    {
+        const auto* source = input.data() + sheets + index * sheetSize;
+        auto* destination  = output.data() + sheets + index * newSheet;
+
+        const auto coverage = readCoverage(source, width, height, format);
+        writeDistanceField(coverage, width, height, spread, destination);
+    }
+
+    return output;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "usage: %s <input.bcfnt> <output.bcfnt> [spread]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const int spread = argc > 3 ? std::atoi(argv[3]) : DEFAULT_SPREAD;
+
+    try
+    {
+        if (spread < 1)
+            throw love::Exception("Spread must be at least 1 texel.");
+
+        writeFile(argv[2], convert(readFile(argv[1]), spread));
+    }
+    catch (const love::Exception& e)
+    {
+        std::fprintf(stderr, "bcfnt2sdf: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}